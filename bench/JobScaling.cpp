@@ -0,0 +1,99 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "job/JobSystem.h"
+#include "render/Image.h"
+
+using namespace std;
+
+/**
+ * Forward frame of a 1024x1024 image filled with small triangles, and 4x multisample resolve of the same image,
+ * timed for pools of 1 to 64 threads.
+ * Usage: jobscaling [maxThreads] [--pin]
+ */
+namespace
+{
+    constexpr int imageSize = 1024;
+    constexpr int frames = 5;
+
+    vector<Triangle> makeGrid(int cells)
+    {
+        vector<Triangle> triangles;
+        triangles.reserve(static_cast<size_t>(cells) * cells * 2);
+        Real step = Real(2) / cells;
+        for (int j = 0; j < cells; ++j)
+        {
+            for (int i = 0; i < cells; ++i)
+            {
+                Real x = -1 + i * step, y = -1 + j * step;
+                TGAColor c(static_cast<unsigned char>(i * 255 / cells), static_cast<unsigned char>(j * 255 / cells),
+                           128, 255);
+                TGAColor d(255, static_cast<unsigned char>(i * 255 / cells), 64, 255);
+                Point p00{{x, y, 0}, c}, p10{{x + step, y, 0}, d}, p01{{x, y + step, 0}, d},
+                        p11{{x + step, y + step, 0}, c};
+                triangles.emplace_back(p00, p10, p11);
+                triangles.emplace_back(p00, p11, p01);
+            }
+        }
+        return triangles;
+    }
+
+    template<typename F>
+    double millisecondsPerFrame(F &&f)
+    {
+        f();
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i)
+        {
+            f();
+        }
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / frames;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned maxThreads = 64;
+    bool pin = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--pin") == 0)
+        {
+            pin = true;
+        } else
+        {
+            maxThreads = static_cast<unsigned>(stoul(argv[i]));
+        }
+    }
+    auto triangles = makeGrid(256);
+    Mat4 mtProj = makeOrthographicProjectTrans(-1, -1, 1, 1, 1, -1);
+    Mat4 mtCam = makeCameraTrans(Vec3(0, 0, 0), Vec3(0, 0, -1), Vec3(0, 1, 0));
+    cout << "hardware threads: " << thread::hardware_concurrency() << ", triangles: " << triangles.size() << "\n";
+    cout << setw(8) << "threads" << setw(14) << "draw ms" << setw(10) << "speedup" << setw(14) << "resolve ms"
+         << setw(10) << "speedup" << "\n";
+    double drawBase = 0, resolveBase = 0;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        JobSystem jobs(threads, pin);
+        Image img(imageSize, imageSize, mtProj, mtCam);
+        img.setJobSystem(jobs);
+        double draw = millisecondsPerFrame([&] { img.drawTriangles(triangles); });
+        img.setMultisample(4, SampleBuffer::Filter::Tent);
+        double resolve = millisecondsPerFrame([&] { img.resolve(); });
+        if (threads == 1)
+        {
+            drawBase = draw;
+            resolveBase = resolve;
+        }
+        cout << fixed << setprecision(2) << setw(8) << threads << setw(14) << draw << setw(10) << drawBase / draw
+             << setw(14) << resolve << setw(10) << resolveBase / resolve << "\n";
+    }
+    return 0;
+}
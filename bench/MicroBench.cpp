@@ -0,0 +1,470 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "linear/Vec.h"
+#include "linear/Mat.h"
+#include "render/Blend.h"
+#include "render/Image.h"
+#include "tgaimage/tgaimage.h"
+
+/**
+ * Microbenchmarks of the linear algebra, the rasterizer entry points and TGAImage.
+ * Inputs come from fixed seeds so every run measures the same work; run through the bench-json target to get the
+ * results as JSON.
+ */
+namespace
+{
+    std::mt19937 &rng()
+    {
+        static std::mt19937 gen(20261019);
+        return gen;
+    }
+
+    Real uniform(Real lo, Real hi)
+    {
+        return std::uniform_real_distribution<Real>(lo, hi)(rng());
+    }
+
+    Vec3 randomVec3()
+    {
+        return Vec3{uniform(-1, 1), uniform(-1, 1), uniform(-1, 1)};
+    }
+
+    Mat4 randomMat4()
+    {
+        Mat4 m;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+            {
+                m[i][j] = uniform(-1, 1);
+            }
+        }
+        return m;
+    }
+
+    /**
+     * Image with an identity camera: NDC coordinates are drawn as they are
+     */
+    Image makeImage(int width, int height)
+    {
+        return {width, height, makeOrthographicProjectTrans(-1, -1, 1, 1, 1, -1),
+                makeCameraTrans(Vec3(0, 0, 0), Vec3(0, 0, -1), Vec3(0, 1, 0))};
+    }
+
+    /**
+     * Image with smooth gradients and flat areas, so RLE has both raw and run packets to write
+     */
+    TGAImage makePattern(int width, int height)
+    {
+        TGAImage img(width, height, TGAImage::RGB);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto v = static_cast<unsigned char>((x / 16 + y / 16) % 2 ? 200 : x ^ y);
+                img.set(x, y, TGAColor(v, static_cast<unsigned char>(y), 64, 255));
+            }
+        }
+        return img;
+    }
+
+    std::string tempFile(const char *name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+}
+
+static void vecDot(benchmark::State &state)
+{
+    Vec3 a = randomVec3(), b = randomVec3();
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(a.dot(b));
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(vecDot);
+
+static void vecCross(benchmark::State &state)
+{
+    Vec3 a = randomVec3(), b = randomVec3();
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(a.cross(b));
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(vecCross);
+
+static void vecNormalized(benchmark::State &state)
+{
+    Vec3 a = randomVec3();
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(a.normalized());
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(vecNormalized);
+
+static void matRightMultiVec(benchmark::State &state)
+{
+    Mat4 m = randomMat4();
+    Vec4 v(randomVec3(), 1);
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(m.rightMulti(v));
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(matRightMultiVec);
+
+static void matRightMultiMat(benchmark::State &state)
+{
+    Mat4 a = randomMat4(), b = randomMat4();
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(a.rightMulti(b));
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(matRightMultiMat);
+
+static void matDeterminant(benchmark::State &state)
+{
+    Mat4 m = randomMat4();
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(m.determinant());
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(matDeterminant);
+
+/**
+ * Clipped line walk between random endpoints, length about state.range(0) pixels
+ */
+static void drawLine(benchmark::State &state)
+{
+    auto img = makeImage(1024, 1024);
+    auto length = static_cast<Real>(state.range(0));
+    const TGAColor c0(255, 0, 0, 255), c1(0, 0, 255, 255);
+    for (auto _: state)
+    {
+        state.PauseTiming();
+        Real x = uniform(0, 1024 - length), y = uniform(0, 1024 - length), a = uniform(0, Real(1.57));
+        state.ResumeTiming();
+        img.draw(static_cast<int>(x), static_cast<int>(y), c0, static_cast<int>(x + length * std::cos(a)),
+                 static_cast<int>(y + length * std::sin(a)), c1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(drawLine)->Arg(8)->Arg(64)->Arg(512);
+
+/**
+ * Screen space triangle with legs of state.range(0) pixels, so about range^2 / 2 covered pixels
+ */
+static void drawTriangle(benchmark::State &state)
+{
+    auto img = makeImage(1024, 1024);
+    int size = static_cast<int>(state.range(0));
+    const TGAColor c0(255, 0, 0, 255), c1(0, 255, 0, 255), c2(0, 0, 255, 255);
+    for (auto _: state)
+    {
+        state.PauseTiming();
+        int x = static_cast<int>(uniform(0, static_cast<Real>(1024 - size))),
+                y = static_cast<int>(uniform(0, static_cast<Real>(1024 - size)));
+        state.ResumeTiming();
+        img.draw(x, y, c0, x + size, y, c1, x, y + size, c2);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0) / 2);
+}
+
+BENCHMARK(drawTriangle)->Arg(4)->Arg(32)->Arg(256)->Arg(1024);
+
+static void tgaSet(benchmark::State &state)
+{
+    TGAImage img(512, 512, TGAImage::RGB);
+    const TGAColor c(10, 20, 30, 255);
+    for (auto _: state)
+    {
+        for (int y = 0; y < 512; ++y)
+        {
+            for (int x = 0; x < 512; ++x)
+            {
+                img.set(x, y, c);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 512 * 512);
+}
+
+BENCHMARK(tgaSet);
+
+static void tgaGet(benchmark::State &state)
+{
+    auto img = makePattern(512, 512);
+    for (auto _: state)
+    {
+        unsigned sum = 0;
+        for (int y = 0; y < 512; ++y)
+        {
+            for (int x = 0; x < 512; ++x)
+            {
+                sum += img.get(x, y).r;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 512 * 512);
+}
+
+BENCHMARK(tgaGet);
+
+static void tgaFlipHorizontally(benchmark::State &state)
+{
+    auto img = makePattern(1024, 1024);
+    for (auto _: state)
+    {
+        img.flip_horizontally();
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 1024 * 1024 * 3);
+}
+
+BENCHMARK(tgaFlipHorizontally);
+
+static void tgaFlipVertically(benchmark::State &state)
+{
+    auto img = makePattern(1024, 1024);
+    for (auto _: state)
+    {
+        img.flip_vertically();
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 1024 * 1024 * 3);
+}
+
+BENCHMARK(tgaFlipVertically);
+
+/**
+ * Scale a 512x512 image to state.range(0) squared
+ */
+static void tgaScale(benchmark::State &state)
+{
+    auto source = makePattern(512, 512);
+    int size = static_cast<int>(state.range(0));
+    for (auto _: state)
+    {
+        state.PauseTiming();
+        TGAImage img(source);
+        state.ResumeTiming();
+        img.scale(size, size);
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(tgaScale)->Arg(256)->Arg(1024);
+
+/**
+ * Clear a 1080p image of state.range(0) bytes per pixel to a color, against the plain memset of clearing to black
+ */
+static void tgaClearColor(benchmark::State &state)
+{
+    auto bpp = static_cast<int>(state.range(0));
+    TGAImage img(1920, 1080, bpp);
+    const TGAColor c(30, 60, 90, 255);
+    for (auto _: state)
+    {
+        img.clear(c);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 1920 * 1080 * bpp);
+}
+
+BENCHMARK(tgaClearColor)->Arg(1)->Arg(3)->Arg(4);
+
+static void tgaClearBlack(benchmark::State &state)
+{
+    TGAImage img(1920, 1080, TGAImage::RGB);
+    for (auto _: state)
+    {
+        img.clear();
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 1920 * 1080 * 3);
+}
+
+BENCHMARK(tgaClearBlack);
+
+/**
+ * Hand a 1080p frame from the rendering stage to the encoding one: by copy with state.range(0) 0, by moves with 1
+ */
+static void framebufferHandoff(benchmark::State &state)
+{
+    TGAImage rendering(1920, 1080, TGAImage::RGB), encoding(1920, 1080, TGAImage::RGB);
+    for (auto _: state)
+    {
+        if (state.range(0) == 0)
+        {
+            encoding = rendering;
+        } else
+        {
+            std::swap(rendering, encoding);
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(framebufferHandoff)->Arg(0)->Arg(1);
+
+/**
+ * Deferred 1080p frames of a few triangles, where the framebuffers cost more than the drawing: state.range(0) 0 makes
+ * a new image per frame, as the callers used to, allocating and zeroing its G-buffer too; 1 clears the same image to
+ * a background color, its G-buffer being emptied by the resolve
+ */
+static void frameLoop(benchmark::State &state)
+{
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 16; ++i)
+    {
+        Real x = uniform(-1, Real(0.8)), y = uniform(-1, Real(0.8));
+        triangles.emplace_back(Point{{x, y, 0}, TGAColor(255, 0, 0, 255)},
+                               Point{{x + Real(0.02), y, 0}, TGAColor(0, 255, 0, 255)},
+                               Point{{x, y + Real(0.02), 0}, TGAColor(0, 0, 255, 255)});
+    }
+    const TGAColor background(40, 40, 40, 255);
+    auto reused = makeImage(1920, 1080);
+    reused.setShadingMode(Image::ShadingMode::Deferred);
+    for (auto _: state)
+    {
+        if (state.range(0) == 0)
+        {
+            auto img = makeImage(1920, 1080);
+            img.setShadingMode(Image::ShadingMode::Deferred);
+            img.drawTriangles(triangles);
+            img.resolve();
+            benchmark::DoNotOptimize(img.buffer());
+        } else
+        {
+            reused.clear(background);
+            reused.drawTriangles(triangles);
+            reused.resolve();
+            benchmark::DoNotOptimize(reused.buffer());
+        }
+    }
+}
+
+BENCHMARK(frameLoop)->Arg(0)->Arg(1);
+
+/**
+ * Blend a row of 1920 fragments into an RGB row with mode state.range(0): replace, over, additive, premultiplied
+ */
+static void blendRow(benchmark::State &state)
+{
+    auto mode = static_cast<BlendMode>(state.range(0));
+    std::vector<TGAColor> fragments(1920);
+    for (auto &c: fragments)
+    {
+        c = TGAColor(static_cast<unsigned char>(uniform(0, 255)), static_cast<unsigned char>(uniform(0, 255)),
+                     static_cast<unsigned char>(uniform(0, 255)), static_cast<unsigned char>(uniform(0, 255)));
+    }
+    std::vector<unsigned char> row(1920 * 3, 40);
+    for (auto _: state)
+    {
+        blendSpan(mode, row.data(), fragments.data(), fragments.size(), 3);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 1920);
+}
+
+BENCHMARK(blendRow)->DenseRange(0, 3);
+
+/**
+ * 1080p frames of 2000 translucent triangles at random depths over a background: state.range(0) 0 sorts them back to
+ * front every frame and blends them over in order, 1 draws them unsorted with order-independent transparency
+ */
+static void transparentOverlay(benchmark::State &state)
+{
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 2000; ++i)
+    {
+        Real x = uniform(-1, Real(0.9)), y = uniform(-1, Real(0.9)), z = uniform(-1, 1);
+        TGAColor c(static_cast<unsigned char>(uniform(0, 255)), static_cast<unsigned char>(uniform(0, 255)), 128, 96);
+        triangles.emplace_back(Point{{x, y, z}, c}, Point{{x + Real(0.1), y, z}, c}, Point{{x, y + Real(0.1), z}, c});
+    }
+    bool oit = state.range(0) == 1;
+    auto img = makeImage(1920, 1080);
+    img.setBlendMode(BlendMode::Over);
+    img.setOrderIndependent(oit);
+    std::vector<Triangle> sorted;
+    for (auto _: state)
+    {
+        img.clear(TGAColor(40, 40, 40, 255));
+        if (oit)
+        {
+            img.drawTriangles(triangles);
+        } else
+        {
+            // Greater z is closer: farthest first
+            sorted = triangles;
+            std::sort(sorted.begin(), sorted.end(), [](const Triangle &a, const Triangle &b)
+            {
+                return a.p1.getZ() < b.p1.getZ();
+            });
+            img.drawTriangles(sorted);
+        }
+        img.resolve();
+        benchmark::DoNotOptimize(img.buffer());
+    }
+}
+
+BENCHMARK(transparentOverlay)->Arg(0)->Arg(1);
+
+static void rleEncode(benchmark::State &state)
+{
+    auto img = makePattern(1024, 1024);
+    auto filename = tempFile("cg_bench_encode.tga");
+    for (auto _: state)
+    {
+        img.write_tga_file(filename.c_str(), true);
+    }
+    state.SetBytesProcessed(state.iterations() * 1024 * 1024 * 3);
+    std::filesystem::remove(filename);
+}
+
+BENCHMARK(rleEncode);
+
+static void rleDecode(benchmark::State &state)
+{
+    auto filename = tempFile("cg_bench_decode.tga");
+    makePattern(1024, 1024).write_tga_file(filename.c_str(), true);
+    TGAImage img;
+    for (auto _: state)
+    {
+        img.read_tga_file(filename.c_str());
+    }
+    state.SetBytesProcessed(state.iterations() * 1024 * 1024 * 3);
+    std::filesystem::remove(filename);
+}
+
+BENCHMARK(rleDecode);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,275 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "memory/HeapCounter.h"
+#include "profile/Profiler.h"
+#include "render/Image.h"
+
+using namespace std;
+
+/**
+ * End-to-end frames of procedural scenes through Image, at 512x512, 1920x1080 and 3840x2160.
+ * Each frame clears the image, draws the scene with the batch API, resolves and encodes it to an RLE TGA file; the
+ * report gives the time of each of those stages, triangles or lines per second, pixels per second, the heap
+ * allocations of drawing and resolving a frame, which are 0 once the image has warmed up, and the peak resident set
+ * of the process so far.
+ * With --trace, the stage report of the last frame of each run is printed and every frame is written as a Chrome
+ * trace; both are empty unless built with CG_PROFILE.
+ * Usage: scenebench [--frames n] [--deferred] [--msaa 4|8] [--scene name] [--trace file]
+ */
+namespace
+{
+    struct Options
+    {
+        int frames = 3;
+        bool deferred = false;
+        int msaa = 1;
+        string scene;
+        string trace;
+    };
+
+    struct ProceduralScene
+    {
+        string name;
+        vector<Triangle> triangles;
+        vector<Line> lines;
+
+        [[nodiscard]] size_t primitives() const
+        {
+            return triangles.size() + lines.size();
+        }
+    };
+
+    struct Resolution
+    {
+        const char *name;
+        int width, height;
+    };
+
+    constexpr Resolution resolutions[] = {{"512x512", 512, 512}, {"1080p", 1920, 1080}, {"4K", 3840, 2160}};
+
+    TGAColor gradient(Real u, Real v)
+    {
+        return {static_cast<unsigned char>(u * 255), static_cast<unsigned char>(v * 255), 128, 255};
+    }
+
+    /**
+     * Sphere of radius 0.9 tessellated in slices x stacks quads
+     */
+    ProceduralScene makeSphere(int slices, int stacks)
+    {
+        ProceduralScene scene{"sphere", {}, {}};
+        auto at = [&](int i, int j)
+        {
+            Real theta = Real(M_PI) * j / stacks, phi = 2 * Real(M_PI) * i / slices;
+            return Point{Vec3{Real(0.9) * sin(theta) * cos(phi), Real(0.9) * cos(theta),
+                              Real(0.9) * sin(theta) * sin(phi)},
+                         gradient(static_cast<Real>(i) / slices, static_cast<Real>(j) / stacks)};
+        };
+        scene.triangles.reserve(static_cast<size_t>(slices) * stacks * 2);
+        for (int j = 0; j < stacks; ++j)
+        {
+            for (int i = 0; i < slices; ++i)
+            {
+                scene.triangles.emplace_back(at(i, j), at(i + 1, j), at(i + 1, j + 1));
+                scene.triangles.emplace_back(at(i, j), at(i + 1, j + 1), at(i, j + 1));
+            }
+        }
+        return scene;
+    }
+
+    /**
+     * Screen filling grid of cells x cells quads, two triangles each
+     */
+    ProceduralScene makeGrid(int cells)
+    {
+        ProceduralScene scene{"grid", {}, {}};
+        Real step = Real(2) / cells;
+        scene.triangles.reserve(static_cast<size_t>(cells) * cells * 2);
+        for (int j = 0; j < cells; ++j)
+        {
+            for (int i = 0; i < cells; ++i)
+            {
+                Real x = -1 + i * step, y = -1 + j * step;
+                auto c = gradient(static_cast<Real>(i) / cells, static_cast<Real>(j) / cells);
+                Point p00{{x, y, 0}, c}, p10{{x + step, y, 0}, c}, p01{{x, y + step, 0}, c},
+                        p11{{x + step, y + step, 0}, c};
+                scene.triangles.emplace_back(p00, p10, p11);
+                scene.triangles.emplace_back(p00, p11, p01);
+            }
+        }
+        return scene;
+    }
+
+    /**
+     * A few triangles each covering most of the screen, drawn on top of each other
+     */
+    ProceduralScene makeHuge(int count)
+    {
+        ProceduralScene scene{"huge", {}, {}};
+        for (int k = 0; k < count; ++k)
+        {
+            Real a = 2 * Real(M_PI) * k / count;
+            auto corner = [&](Real offset)
+            {
+                return Vec3{Real(1.4) * cos(a + offset), Real(1.4) * sin(a + offset), 0};
+            };
+            scene.triangles.emplace_back(Point{corner(0), gradient(1, 0)},
+                                         Point{corner(2 * Real(M_PI) / 3), gradient(0, 1)},
+                                         Point{corner(4 * Real(M_PI) / 3), gradient(0, 0)});
+        }
+        return scene;
+    }
+
+    /**
+     * Long lines crossing the whole screen, fanning out from opposite sides
+     */
+    ProceduralScene makeWireframe(int count)
+    {
+        ProceduralScene scene{"wireframe", {}, {}};
+        scene.lines.reserve(count);
+        for (int k = 0; k < count; ++k)
+        {
+            Real t = -1 + 2 * static_cast<Real>(k) / count;
+            scene.lines.emplace_back(Point{{-1, t, 0}, gradient(1, 0)}, Point{{1, -t, 0}, gradient(0, 1)});
+        }
+        return scene;
+    }
+
+    long peakRssKb()
+    {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    double elapsedMs(chrono::steady_clock::time_point since)
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+    }
+
+    void run(const ProceduralScene &scene, const Options &options)
+    {
+        auto encoded = (filesystem::temp_directory_path() / "cg_scenebench.tga").string();
+        for (auto &res: resolutions)
+        {
+            Image img(res.width, res.height, makeOrthographicProjectTrans(-1, -1, 1, 1, 1, -1),
+                      makeCameraTrans(Vec3(0, 0, 0), Vec3(0, 0, -1), Vec3(0, 1, 0)));
+            if (options.deferred)
+            {
+                img.setShadingMode(Image::ShadingMode::Deferred);
+            }
+            img.setMultisample(options.msaa);
+            double draw = 0, resolve = 0, encode = 0;
+            uint64_t allocations = 0;
+            Profiler::FrameReport report;
+            // One untimed frame first, to leave out page faults of first touches
+            for (int frame = -1; frame < options.frames; ++frame)
+            {
+                // Samples, G-buffer and transparency included, so every frame draws the same
+                img.clear();
+                Profiler::beginFrame();
+                auto start = chrono::steady_clock::now();
+                auto allocated = heapAllocations();
+                img.drawTriangles(scene.triangles);
+                img.drawLines(scene.lines);
+                double d = elapsedMs(start);
+                start = chrono::steady_clock::now();
+                img.resolve();
+                double r = elapsedMs(start);
+                allocated = heapAllocations() - allocated;
+                start = chrono::steady_clock::now();
+                {
+                    Profiler::Scope scope("encode");
+                    img.write_tga_file(encoded.c_str());
+                }
+                double e = elapsedMs(start);
+                report = Profiler::endFrame();
+                if (frame >= 0)
+                {
+                    draw += d, resolve += r, encode += e;
+                    allocations += allocated;
+                }
+            }
+            draw /= options.frames, resolve /= options.frames, encode /= options.frames;
+            double frame = draw + resolve + encode;
+            double pixels = static_cast<double>(res.width) * res.height;
+            cout << fixed << setprecision(2) << left << setw(11) << scene.name << setw(10) << res.name << right
+                 << setw(10) << frame << setw(10) << draw << setw(10) << resolve << setw(10) << encode
+                 << setw(12) << static_cast<double>(scene.primitives()) / draw / 1e3 << setw(12)
+                 << pixels / frame / 1e3 << setw(8) << allocations / options.frames << setw(10)
+                 << static_cast<double>(peakRssKb()) / 1024 << "\n";
+            if (!options.trace.empty())
+            {
+                report.print(cout);
+            }
+        }
+        filesystem::remove(encoded);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            options.frames = max(1, stoi(argv[++i]));
+        } else if (strcmp(argv[i], "--deferred") == 0)
+        {
+            options.deferred = true;
+        } else if (strcmp(argv[i], "--msaa") == 0 && i + 1 < argc)
+        {
+            options.msaa = stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc)
+        {
+            options.scene = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            options.trace = argv[++i];
+        } else
+        {
+            cerr << "usage: " << argv[0] << " [--frames n] [--deferred] [--msaa 4|8] [--scene name] [--trace file]\n";
+            return 1;
+        }
+    }
+    if (options.msaa != 1 && options.msaa != 4 && options.msaa != 8)
+    {
+        cerr << "--msaa takes 1, 4 or 8\n";
+        return 1;
+    }
+    cout << left << setw(11) << "scene" << setw(10) << "size" << right << setw(10) << "frame ms" << setw(10)
+         << "draw ms" << setw(10) << "resolve" << setw(10) << "encode" << setw(12) << "Mprim/s" << setw(12)
+         << "Mpix/s" << setw(8) << "allocs" << setw(10) << "RSS MB" << "\n";
+    // Scenes are made one at a time, so the peak resident set follows the largest one
+    const vector<pair<string, function<ProceduralScene()>>> scenes = {
+            {"sphere",    [] { return makeSphere(256, 128); }},
+            {"grid",      [] { return makeGrid(708); }},
+            {"huge",      [] { return makeHuge(8); }},
+            {"wireframe", [] { return makeWireframe(20000); }}};
+    for (auto &[name, make]: scenes)
+    {
+        if (options.scene.empty() || options.scene == name)
+        {
+            run(make(), options);
+        }
+    }
+    if (!options.trace.empty() && !Profiler::writeChromeTrace(options.trace.c_str()))
+    {
+        cerr << "can't write file " << options.trace << "\n";
+        return 1;
+    }
+    return 0;
+}
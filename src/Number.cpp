@@ -3,3 +3,13 @@
 //
 
 #include "Number.h"
+
+std::ostream &operator<<(std::ostream &os, const Number &number)
+{
+    os << number.upper;
+    if (number.dividend != 1)
+    {
+        os << "/" << number.dividend;
+    }
+    return os;
+}
@@ -5,14 +5,185 @@
 #ifndef CG_NUMBER_H
 #define CG_NUMBER_H
 
+#include <cassert>
+#include <compare>
+#include <ostream>
+#include <stdexcept>
 
+
+/**
+ * Exact rational number upper / dividend, kept normalized: dividend > 0 and gcd(upper, dividend) == 1.
+ * Integers (dividend == 1) take a fast path checked with the overflow builtins; anything that leaves 64 bits is
+ * redone in __int128 and reduced, and only a result that still doesn't fit throws std::overflow_error.
+ */
 class Number
 {
 private:
     long long upper = 0;
     long long dividend = 1;
+
+    using Wide = __int128;
+
+    static constexpr Wide gcd(Wide a, Wide b)
+    {
+        a = a < 0 ? -a : a;
+        b = b < 0 ? -b : b;
+        while (b != 0)
+        {
+            Wide t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    /**
+     * Normalize a wide fraction back into 64 bits
+     */
+    static constexpr Number make(Wide up, Wide div)
+    {
+        assert(div != 0);
+        if (div < 0)
+        {
+            up = -up;
+            div = -div;
+        }
+        if (div != 1)
+        {
+            Wide g = gcd(up, div);
+            if (g > 1)
+            {
+                up /= g;
+                div /= g;
+            }
+        }
+        constexpr Wide lo = static_cast<Wide>(-0x7fffffffffffffffLL - 1), hi = 0x7fffffffffffffffLL;
+        if (up < lo || up > hi || div > hi)
+        {
+            throw std::overflow_error("Number: result does not fit in 64 bits");
+        }
+        Number ret;
+        ret.upper = static_cast<long long>(up);
+        ret.dividend = static_cast<long long>(div);
+        return ret;
+    }
+
 public:
+    constexpr Number() = default;
+
+    constexpr Number(long long value) : upper(value) {}
+
+    constexpr Number(long long upper, long long dividend) : Number(make(upper, dividend)) {}
+
+    [[nodiscard]] constexpr long long numerator() const
+    {
+        return upper;
+    }
+
+    [[nodiscard]] constexpr long long denominator() const
+    {
+        return dividend;
+    }
+
+    [[nodiscard]] constexpr bool isInteger() const
+    {
+        return dividend == 1;
+    }
+
+    [[nodiscard]] constexpr int sign() const
+    {
+        return (upper > 0) - (upper < 0);
+    }
+
+    explicit constexpr operator double() const
+    {
+        return static_cast<double>(upper) / static_cast<double>(dividend);
+    }
+
+    constexpr Number operator-() const
+    {
+        if (upper == -0x7fffffffffffffffLL - 1)
+        {
+            return make(-static_cast<Wide>(upper), dividend);
+        }
+        Number ret = *this;
+        ret.upper = -upper;
+        return ret;
+    }
+
+    friend constexpr Number operator+(const Number &l, const Number &r)
+    {
+        long long sum;
+        if (l.dividend == r.dividend && !__builtin_add_overflow(l.upper, r.upper, &sum))
+        {
+            return l.dividend == 1 ? Number(sum) : make(sum, l.dividend);
+        }
+        return make(static_cast<Wide>(l.upper) * r.dividend + static_cast<Wide>(r.upper) * l.dividend,
+                    static_cast<Wide>(l.dividend) * r.dividend);
+    }
+
+    friend constexpr Number operator-(const Number &l, const Number &r)
+    {
+        long long diff;
+        if (l.dividend == r.dividend && !__builtin_sub_overflow(l.upper, r.upper, &diff))
+        {
+            return l.dividend == 1 ? Number(diff) : make(diff, l.dividend);
+        }
+        return make(static_cast<Wide>(l.upper) * r.dividend - static_cast<Wide>(r.upper) * l.dividend,
+                    static_cast<Wide>(l.dividend) * r.dividend);
+    }
+
+    friend constexpr Number operator*(const Number &l, const Number &r)
+    {
+        long long prod;
+        if ((l.dividend | r.dividend) == 1 && !__builtin_mul_overflow(l.upper, r.upper, &prod))
+        {
+            return Number(prod);
+        }
+        return make(static_cast<Wide>(l.upper) * r.upper, static_cast<Wide>(l.dividend) * r.dividend);
+    }
+
+    friend constexpr Number operator/(const Number &l, const Number &r)
+    {
+        assert(r.upper != 0);
+        return make(static_cast<Wide>(l.upper) * r.dividend, static_cast<Wide>(l.dividend) * r.upper);
+    }
+
+    constexpr Number &operator+=(const Number &other)
+    {
+        return *this = *this + other;
+    }
+
+    constexpr Number &operator-=(const Number &other)
+    {
+        return *this = *this - other;
+    }
+
+    constexpr Number &operator*=(const Number &other)
+    {
+        return *this = *this * other;
+    }
+
+    constexpr Number &operator/=(const Number &other)
+    {
+        return *this = *this / other;
+    }
+
+    friend constexpr bool operator==(const Number &l, const Number &r) = default;
+
+    /**
+     * Cross multiplication in __int128 never overflows, so the comparison is always exact
+     */
+    friend constexpr std::strong_ordering operator<=>(const Number &l, const Number &r)
+    {
+        if (l.dividend == r.dividend)
+        {
+            return l.upper <=> r.upper;
+        }
+        return static_cast<Wide>(l.upper) * r.dividend <=> static_cast<Wide>(r.upper) * l.dividend;
+    }
 
+    friend std::ostream &operator<<(std::ostream &os, const Number &number);
 };
 
 
@@ -0,0 +1,181 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "AssetCache.h"
+#include "scene/MeshLoader.h"
+
+AssetCache &AssetCache::shared()
+{
+    static AssetCache cache;
+    return cache;
+}
+
+std::shared_ptr<const TGAImage> AssetCache::getTexture(const std::filesystem::path &path)
+{
+    return std::static_pointer_cast<const TGAImage>(get('t', path, [](const std::string &filename) -> Loaded
+    {
+        auto image = std::make_shared<TGAImage>();
+        if (!image->read_tga_file(filename.c_str()))
+        {
+            return {nullptr, 0};
+        }
+        size_t bytes = sizeof(TGAImage) +
+                       static_cast<size_t>(image->get_width()) * image->get_height() * image->get_bytespp();
+        return {std::move(image), bytes};
+    }));
+}
+
+std::shared_ptr<const Mesh> AssetCache::getMesh(const std::filesystem::path &path)
+{
+    return std::static_pointer_cast<const Mesh>(get('m', path, [](const std::string &filename) -> Loaded
+    {
+        auto mesh = std::make_shared<Mesh>();
+        if (!loadMesh(filename.c_str(), *mesh))
+        {
+            return {nullptr, 0};
+        }
+        size_t bytes = sizeof(Mesh) + mesh->positions.capacity() * sizeof(Vec3) +
+                       mesh->colors.capacity() * sizeof(TGAColor) + mesh->indices.capacity() * sizeof(uint32_t);
+        return {std::move(mesh), bytes};
+    }));
+}
+
+AssetCache::Asset AssetCache::get(char kind, const std::filesystem::path &path,
+                                  const std::function<Loaded(const std::string &)> &load)
+{
+    auto filename = std::filesystem::absolute(path).lexically_normal().string();
+    std::error_code ec;
+    auto time = static_cast<int64_t>(std::filesystem::last_write_time(filename, ec).time_since_epoch().count());
+    auto key = kind + filename;
+    std::promise<Asset> promise;
+    std::shared_future<Asset> cached;
+    uint64_t generation = 0;
+    {
+        std::lock_guard lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.time == time)
+        {
+            ++stats.hits;
+            lru.splice(lru.begin(), lru, it->second.lru);
+            cached = it->second.value;
+        } else if (it != entries.end())
+        {
+            // Changed on disk: whoever holds the old version keeps it
+            erase(it);
+        }
+        if (!cached.valid())
+        {
+            ++stats.loads;
+            generation = ++generations;
+            lru.push_front(key);
+            entries.emplace(key, Entry{time, promise.get_future().share(), 0, false, generation, lru.begin()});
+        }
+    }
+    if (cached.valid())
+    {
+        // Waits if another request is still loading it
+        return cached.get();
+    }
+    Loaded loaded;
+    try
+    {
+        loaded = load(filename);
+    } catch (...)
+    {
+        // Handed to the requests waiting for this load, and not cached, so the next request tries again
+        promise.set_exception(std::current_exception());
+        std::lock_guard lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.generation == generation)
+        {
+            erase(it);
+        }
+        throw;
+    }
+    auto &[asset, bytes] = loaded;
+    // Set before the entry is marked ready, as eviction reads the value of ready entries
+    promise.set_value(asset);
+    {
+        std::lock_guard lock(mutex);
+        auto it = entries.find(key);
+        // The entry may be gone: cleared, or replaced by a newer version of the file
+        if (it != entries.end() && it->second.generation == generation)
+        {
+            if (asset)
+            {
+                it->second.bytes = bytes;
+                it->second.ready = true;
+                stats.bytes += bytes;
+            } else
+            {
+                // Not cached, so the next request tries again
+                erase(it);
+            }
+        }
+        evict();
+    }
+    return asset;
+}
+
+void AssetCache::erase(std::unordered_map<std::string, Entry>::iterator it)
+{
+    if (it->second.ready)
+    {
+        stats.bytes -= it->second.bytes;
+    }
+    lru.erase(it->second.lru);
+    entries.erase(it);
+}
+
+void AssetCache::evict()
+{
+    auto key = lru.end();
+    while (stats.bytes > budget && key != lru.begin())
+    {
+        auto it = entries.find(*--key);
+        // Only the entry holds an unused asset
+        if (it->second.ready && it->second.value.get().use_count() == 1)
+        {
+            // Step past it first: erasing it invalidates key
+            ++key;
+            erase(it);
+            ++stats.evictions;
+        }
+    }
+}
+
+void AssetCache::setBudget(size_t bytes)
+{
+    std::lock_guard lock(mutex);
+    budget = bytes;
+    evict();
+}
+
+size_t AssetCache::getBudget() const
+{
+    std::lock_guard lock(mutex);
+    return budget;
+}
+
+AssetCache::Stats AssetCache::getStats() const
+{
+    std::lock_guard lock(mutex);
+    auto s = stats;
+    s.entries = entries.size();
+    return s;
+}
+
+void AssetCache::clear()
+{
+    std::lock_guard lock(mutex);
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        auto next = std::next(it);
+        if (it->second.ready && it->second.value.get().use_count() == 1)
+        {
+            erase(it);
+        }
+        it = next;
+    }
+}
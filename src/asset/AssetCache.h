@@ -0,0 +1,137 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_ASSETCACHE_H
+#define CG_ASSETCACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "scene/Mesh.h"
+#include "tgaimage/tgaimage.h"
+
+/**
+ * Process wide cache of decoded textures and meshes, keyed by path and checked against the modification time of
+ * the file on every request, so an edited file is loaded again.
+ * Assets are handed out as shared pointers to const: every job using one shares the same memory, and an asset
+ * stays valid as long as someone holds it, even once evicted.
+ * Concurrent requests for the same file load it once: the first one loads without holding the lock, the others wait
+ * for its result. Other files load in parallel. A load that throws throws in every request waiting for it, and the
+ * next request loads again.
+ * The cache keeps at most its budget of bytes alive by itself: past it, the least recently used assets nobody else
+ * holds are dropped. Assets in use are never dropped, so the budget can be exceeded while they are.
+ */
+class AssetCache
+{
+public:
+    struct Stats
+    {
+        uint64_t hits = 0;
+        /**
+         * Requests that loaded the file
+         */
+        uint64_t loads = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        /**
+         * Memory of the assets kept, loading ones excluded
+         */
+        size_t bytes = 0;
+    };
+
+    /**
+     * @param budget bytes kept by the cache alone
+     */
+    explicit AssetCache(size_t budget = size_t(1) << 30) : budget(budget) {}
+
+    AssetCache(const AssetCache &) = delete;
+
+    AssetCache &operator=(const AssetCache &) = delete;
+
+    /**
+     * Image read with read_tga_file, flipped as stored
+     * @return null if the file can't be read
+     */
+    std::shared_ptr<const TGAImage> getTexture(const std::filesystem::path &path);
+
+    /**
+     * Mesh loaded with loadMesh, through its binary cache
+     * @return null if the file can't be loaded
+     */
+    std::shared_ptr<const Mesh> getMesh(const std::filesystem::path &path);
+
+    /**
+     * Evict down to the new budget at once
+     */
+    void setBudget(size_t bytes);
+
+    [[nodiscard]] size_t getBudget() const;
+
+    [[nodiscard]] Stats getStats() const;
+
+    /**
+     * Drop every loaded asset not in use. Loads in progress complete.
+     */
+    void clear();
+
+    /**
+     * Cache used by the batch renderer, with the default budget
+     */
+    static AssetCache &shared();
+
+protected:
+    typedef std::shared_ptr<const void> Asset;
+
+    /**
+     * Asset and the memory it takes
+     */
+    typedef std::pair<Asset, size_t> Loaded;
+
+    /**
+     * Asset of any kind, for caches of other kinds deriving from this one
+     * @param kind keeps a texture and a mesh of the same path apart
+     * @param load called on a miss, without the lock, with the file name; a null asset isn't cached
+     */
+    Asset get(char kind, const std::filesystem::path &path, const std::function<Loaded(const std::string &)> &load);
+
+private:
+    struct Entry
+    {
+        int64_t time;
+        std::shared_future<Asset> value;
+        /**
+         * Set once the value is ready, then counted in the budget
+         */
+        size_t bytes;
+        bool ready;
+        uint64_t generation;
+        std::list<std::string>::iterator lru;
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    /**
+     * Keys from the most to the least recently used
+     */
+    std::list<std::string> lru;
+    size_t budget;
+    uint64_t generations = 0;
+    Stats stats;
+
+    void erase(std::unordered_map<std::string, Entry>::iterator it);
+
+    /**
+     * Drop unused ready entries from the least recently used until within budget. The lock must be held.
+     */
+    void evict();
+};
+
+#endif //CG_ASSETCACHE_H
@@ -0,0 +1,321 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "Batch.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Blank separated words of one line, comment stripped
+     */
+    class Words
+    {
+    public:
+        explicit Words(std::string_view line) : rest(line.substr(0, line.find('#'))) {}
+
+        std::string_view next()
+        {
+            auto begin = rest.find_first_not_of(" \t\r");
+            if (begin == std::string_view::npos)
+            {
+                rest = {};
+                return {};
+            }
+            rest.remove_prefix(begin);
+            auto word = rest.substr(0, rest.find_first_of(" \t\r"));
+            rest.remove_prefix(word.size());
+            return word;
+        }
+
+        /**
+         * Consume the next word if it is expected
+         */
+        bool accept(std::string_view expected)
+        {
+            auto saved = rest;
+            if (next() == expected)
+            {
+                return true;
+            }
+            rest = saved;
+            return false;
+        }
+
+        template<typename T>
+        bool number(T &out)
+        {
+            auto word = next();
+            auto [end, ec] = std::from_chars(word.data(), word.data() + word.size(), out);
+            return !word.empty() && ec == std::errc() && end == word.data() + word.size();
+        }
+
+        bool vec3(Vec3 &out)
+        {
+            return number(out[0]) && number(out[1]) && number(out[2]);
+        }
+
+        [[nodiscard]] bool done() const
+        {
+            return rest.find_first_not_of(" \t\r") == std::string_view::npos;
+        }
+
+    private:
+        std::string_view rest;
+    };
+
+    template<typename T>
+    bool find(const std::vector<T> &names, std::string_view name, uint32_t &index)
+    {
+        auto it = std::find(names.begin(), names.end(), name);
+        index = static_cast<uint32_t>(it - names.begin());
+        return it != names.end();
+    }
+
+    bool parseObject(Words &words, const Batch &batch, Batch::Object &object)
+    {
+        if (!find(batch.meshNames, words.next(), object.mesh))
+        {
+            return false;
+        }
+        while (!words.done())
+        {
+            Vec3 v;
+            Real degrees;
+            if (words.accept("translate") && words.vec3(v))
+            {
+                object.world = Affine3::translate(v) * object.world;
+            } else if (words.accept("rotate") && words.vec3(v) && words.number(degrees))
+            {
+                object.world = Affine3(Quaternion::fromAxisAngle(v, degrees * Real(M_PI) / 180), Vec3{0, 0, 0}) *
+                               object.world;
+            } else if (words.accept("scale") && words.vec3(v))
+            {
+                object.world = Affine3::scale(v) * object.world;
+            } else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool parseCamera(Words &words, Batch::Camera &camera)
+    {
+        Vec3 eye, gaze, up;
+        camera.name = words.next();
+        if (camera.name.empty() || !words.accept("eye") || !words.vec3(eye) || !words.accept("gaze") ||
+            !words.vec3(gaze) || !words.accept("up") || !words.vec3(up))
+        {
+            return false;
+        }
+        bool perspective = words.accept("perspective");
+        if (!perspective && !words.accept("orthographic"))
+        {
+            return false;
+        }
+        Real l, b, n, r, t, f;
+        if (!words.number(l) || !words.number(b) || !words.number(n) || !words.number(r) || !words.number(t) ||
+            !words.number(f) || !words.done())
+        {
+            return false;
+        }
+        camera.projection = perspective ? makePerspectiveProjectTrans(l, b, n, r, t, f)
+                                        : makeOrthographicProjectTrans(l, b, n, r, t, f);
+        camera.view = makeCameraTrans(eye, gaze, up);
+        return true;
+    }
+
+    bool parseJob(Words &words, const Batch &batch, const std::filesystem::path &baseDir, Batch::Job &job)
+    {
+        std::vector<std::string_view> names;
+        for (auto &c: batch.cameras)
+        {
+            names.emplace_back(c.name);
+        }
+        if (!find(names, words.next(), job.camera) || !words.number(job.width) || !words.number(job.height) ||
+            job.width <= 0 || job.height <= 0)
+        {
+            return false;
+        }
+        auto output = words.next();
+        if (output.empty())
+        {
+            return false;
+        }
+        job.output = (baseDir / output).string();
+        while (!words.done())
+        {
+            if (words.accept("deferred"))
+            {
+                job.shading = Image::ShadingMode::Deferred;
+            } else if (words.accept("msaa"))
+            {
+                if (!words.number(job.samples) || (job.samples != 4 && job.samples != 8))
+                {
+                    return false;
+                }
+            } else if (words.accept("box"))
+            {
+                job.filter = SampleBuffer::Filter::Box;
+            } else if (words.accept("tent"))
+            {
+                job.filter = SampleBuffer::Filter::Tent;
+            } else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void bake(Batch &batch)
+    {
+        batch.triangles.clear();
+        for (auto &o: batch.objects)
+        {
+            auto &mesh = *batch.meshes[o.mesh];
+            for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+            {
+                auto point = [&](uint32_t v) { return Point(o.world.apply(mesh.positions[v]), mesh.colors[v]); };
+                batch.triangles.emplace_back(point(mesh.indices[i]), point(mesh.indices[i + 1]),
+                                             point(mesh.indices[i + 2]));
+            }
+        }
+    }
+
+    void renderJob(const Batch &batch, const Batch::Job &job, JobSystem &jobs, BatchResult &result)
+    {
+        auto start = Clock::now();
+        auto &camera = batch.cameras[job.camera];
+        Image img(job.width, job.height, camera.projection, camera.view);
+        img.setJobSystem(jobs);
+        img.setShadingMode(job.shading);
+        if (job.samples > 1)
+        {
+            img.setMultisample(job.samples, job.filter);
+        }
+        img.drawTriangles(batch.triangles);
+        img.resolve();
+        auto rendered = Clock::now();
+        auto dir = std::filesystem::path(job.output).parent_path();
+        std::error_code ec;
+        if (!dir.empty())
+        {
+            std::filesystem::create_directories(dir, ec);
+        }
+        result.ok = img.save(job.output.c_str());
+        result.renderMs = std::chrono::duration<double, std::milli>(rendered - start).count();
+        result.encodeMs = std::chrono::duration<double, std::milli>(Clock::now() - rendered).count();
+    }
+}
+
+bool parseBatch(std::string_view text, const std::filesystem::path &baseDir, Batch &batch)
+{
+    batch = Batch();
+    size_t line = 1;
+    for (size_t begin = 0; begin < text.size(); ++line)
+    {
+        auto end = std::min(text.find('\n', begin), text.size());
+        Words words(text.substr(begin, end - begin));
+        begin = end + 1;
+        auto keyword = words.next();
+        bool ok = true;
+        if (keyword.empty())
+        {
+            continue;
+        } else if (keyword == "mesh")
+        {
+            auto name = words.next(), path = words.next();
+            uint32_t existing;
+            ok = !path.empty() && words.done() && !find(batch.meshNames, name, existing);
+            batch.meshNames.emplace_back(name);
+            batch.meshPaths.push_back(baseDir / path);
+        } else if (keyword == "object")
+        {
+            Batch::Object object{};
+            ok = parseObject(words, batch, object);
+            batch.objects.push_back(object);
+        } else if (keyword == "camera")
+        {
+            Batch::Camera camera;
+            ok = parseCamera(words, camera);
+            batch.cameras.push_back(std::move(camera));
+        } else if (keyword == "job")
+        {
+            Batch::Job job{};
+            ok = parseJob(words, batch, baseDir, job);
+            batch.jobs.push_back(std::move(job));
+        } else
+        {
+            ok = false;
+        }
+        if (!ok)
+        {
+            std::cerr << "bad " << keyword << " at line " << line << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool loadBatch(const char *filename, Batch &batch, JobSystem &jobs, AssetCache &assets)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "can't open file " << filename << "\n";
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    if (!parseBatch(text.str(), std::filesystem::path(filename).parent_path(), batch))
+    {
+        return false;
+    }
+    batch.meshes.resize(batch.meshPaths.size());
+    jobs.parallelFor(0, batch.meshPaths.size(), 1, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+        {
+            batch.meshes[i] = assets.getMesh(batch.meshPaths[i]);
+        }
+    });
+    if (std::find(batch.meshes.begin(), batch.meshes.end(), nullptr) != batch.meshes.end())
+    {
+        return false;
+    }
+    bake(batch);
+    return true;
+}
+
+std::vector<BatchResult> renderBatch(const Batch &batch, JobSystem &jobs)
+{
+    std::vector<BatchResult> results(batch.jobs.size());
+    if (batch.jobs.size() < jobs.getThreadCount())
+    {
+        for (size_t i = 0; i < batch.jobs.size(); ++i)
+        {
+            renderJob(batch, batch.jobs[i], jobs, results[i]);
+        }
+        return results;
+    }
+    jobs.parallelFor(0, batch.jobs.size(), 1, [&](size_t b, size_t e)
+    {
+        // The stages of the frame run inline, one frame per thread
+        for (size_t i = b; i < e; ++i)
+        {
+            renderJob(batch, batch.jobs[i], JobSystem::serial(), results[i]);
+        }
+    });
+    return results;
+}
@@ -0,0 +1,111 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_BATCH_H
+#define CG_BATCH_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "asset/AssetCache.h"
+#include "job/JobSystem.h"
+#include "linear/Affine.h"
+#include "render/Image.h"
+#include "scene/Mesh.h"
+
+/**
+ * Render jobs read from a batch file: the meshes and objects of one static scene, the cameras looking at it and the
+ * images to render, one job per line:
+ *
+ *   # comment
+ *   mesh <name> <file.obj>
+ *   object <mesh> [translate x y z] [rotate ax ay az degrees] [scale x y z]
+ *   camera <name> eye x y z gaze x y z up x y z perspective|orthographic l b n r t f
+ *   job <camera> <width> <height> <output.tga> [deferred] [msaa 4|8] [box|tent]
+ *
+ * Object transforms apply in the order written. Relative paths are relative to the batch file.
+ * Meshes come from an asset cache, so a mesh file is loaded once however many entries, objects and batch files use
+ * it, and the objects are baked into one list of world space triangles shared read-only by every job, so a job only
+ * pays for its own rasterization and encoding.
+ */
+struct Batch
+{
+    struct Object
+    {
+        uint32_t mesh;
+        Affine3 world;
+    };
+
+    struct Camera
+    {
+        std::string name;
+        Mat4 projection;
+        Mat4 view;
+    };
+
+    struct Job
+    {
+        uint32_t camera;
+        int width, height;
+        std::string output;
+        Image::ShadingMode shading = Image::ShadingMode::Forward;
+        int samples = 1;
+        SampleBuffer::Filter filter = SampleBuffer::Filter::Box;
+    };
+
+    std::vector<std::string> meshNames;
+    std::vector<std::filesystem::path> meshPaths;
+    std::vector<Object> objects;
+    std::vector<Camera> cameras;
+    std::vector<Job> jobs;
+    /**
+     * Filled by loadBatch
+     */
+    std::vector<std::shared_ptr<const Mesh>> meshes;
+    std::vector<Triangle> triangles;
+};
+
+/**
+ * Time of one job of renderBatch
+ */
+struct BatchResult
+{
+    bool ok = false;
+    /**
+     * Allocation, drawing and resolve
+     */
+    double renderMs = 0;
+    /**
+     * Flip and TGA encoding to the output file
+     */
+    double encodeMs = 0;
+};
+
+/**
+ * Parse the text of a batch file into batch, replacing its content; no file is read
+ * @param baseDir directory the relative paths are resolved against
+ * @return false on a malformed line, reported on std::cerr
+ */
+bool parseBatch(std::string_view text, const std::filesystem::path &baseDir, Batch &batch);
+
+/**
+ * Parse a batch file, then get its meshes from assets in parallel and bake its objects into batch.triangles
+ * @return false if the file can't be read or parsed, or a mesh can't be loaded
+ */
+bool loadBatch(const char *filename, Batch &batch, JobSystem &jobs = JobSystem::shared(),
+               AssetCache &assets = AssetCache::shared());
+
+/**
+ * Render and save every job of a loaded batch.
+ * With at least as many jobs as threads, jobs run in parallel, each rendered on a single thread: whole frames
+ * balance the cores better than the stages of one frame, which wait for each other. With fewer jobs, they run one
+ * after the other, each over the whole pool.
+ * @return one result per job, in order
+ */
+std::vector<BatchResult> renderBatch(const Batch &batch, JobSystem &jobs = JobSystem::shared());
+
+#endif //CG_BATCH_H
@@ -0,0 +1,279 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "JobSystem.h"
+#include "profile/Profiler.h"
+
+namespace
+{
+    /**
+     * Pool and queue of the calling thread when it is a worker
+     */
+    thread_local const JobSystem *currentSystem = nullptr;
+    thread_local size_t currentQueue = 0;
+}
+
+JobSystem::JobSystem(unsigned threadCount, bool pinThreads)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(threadCount - 1);
+    // Workers set up their thread state before the pool is used, not at some later frame
+    std::latch started(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; ++i)
+    {
+        workers.emplace_back(&JobSystem::workerLoop, this, i, pinThreads, std::ref(started));
+    }
+    started.wait();
+}
+
+JobSystem::~JobSystem()
+{
+    stopping.store(true);
+    notify(workers.size());
+    for (auto &w: workers)
+    {
+        w.join();
+    }
+}
+
+JobSystem &JobSystem::shared()
+{
+    static JobSystem system;
+    return system;
+}
+
+JobSystem &JobSystem::serial()
+{
+    static JobSystem system(1);
+    return system;
+}
+
+void JobSystem::workerLoop(unsigned index, bool pin, std::latch &started)
+{
+#ifdef __linux__
+    if (pin)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % std::max(1u, std::thread::hardware_concurrency()), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+    currentSystem = this;
+    currentQueue = index;
+    CG_PROFILE_THREAD();
+    started.count_down();
+    while (true)
+    {
+        if (runOne(index))
+        {
+            continue;
+        }
+        std::unique_lock lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+        if (stopping.load() && queued.load() == 0)
+        {
+            return;
+        }
+    }
+}
+
+size_t JobSystem::queueIndex() const
+{
+    return currentSystem == this ? currentQueue : 0;
+}
+
+void JobSystem::notify(size_t jobs)
+{
+    // Taking the lock orders the change of queued before a worker checking it goes to sleep
+    {
+        std::lock_guard lock(sleepMutex);
+    }
+    if (jobs == 1)
+    {
+        wake.notify_one();
+    } else if (jobs > 1)
+    {
+        wake.notify_all();
+    }
+}
+
+void JobSystem::push(const Job &job)
+{
+    auto &q = *queues[queueIndex()];
+    {
+        std::lock_guard lock(q.mutex);
+        q.pushBack(job);
+    }
+    queued.fetch_add(1);
+    notify(1);
+}
+
+void JobSystem::pushRanges(void (*call)(const void *, size_t, size_t), const void *ctx, size_t begin, size_t end,
+                           size_t grain, Counter &counter)
+{
+    size_t count = (end - begin + grain - 1) / grain;
+    counter.pending.fetch_add(count);
+    auto &q = *queues[queueIndex()];
+    {
+        std::lock_guard lock(q.mutex);
+        // Pushed last range first, so the owner pops them in order and thieves take the far end
+        for (size_t i = count; i-- > 0;)
+        {
+            size_t b = begin + i * grain;
+            q.pushBack(Job{call, ctx, b, std::min(end, b + grain), &counter, {}});
+        }
+    }
+    queued.fetch_add(count);
+    notify(count);
+}
+
+void JobSystem::submit(Job &task, Counter *counter, Counter *dependency)
+{
+    task.counter = counter;
+    if (counter)
+    {
+        counter->pending.fetch_add(1);
+    }
+    if (dependency && park(*dependency, task))
+    {
+        return;
+    }
+    push(task);
+}
+
+bool JobSystem::park(Counter &dependency, const Job &task)
+{
+    std::lock_guard lock(dependency.parkMutex);
+    size_t state = dependency.pending.load(std::memory_order_acquire);
+    do
+    {
+        if ((state & ~Counter::parkedFlag) == 0)
+        {
+            return false;
+        }
+        // Flagged in the same step as the count is checked, so the job taking it to zero sees the flag
+    } while (!dependency.pending.compare_exchange_weak(state, state | Counter::parkedFlag, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire));
+    dependency.parked.push_back(task);
+    return true;
+}
+
+void JobSystem::finish(Counter &counter)
+{
+    // Last access to the counter unless jobs are parked on it: once it is done its owner may destroy it
+    if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) != (Counter::parkedFlag | 1))
+    {
+        return;
+    }
+    std::vector<Job> ready;
+    {
+        std::lock_guard lock(counter.parkMutex);
+        ready.swap(counter.parked);
+        counter.pending.store(0, std::memory_order_release);
+    }
+    // The owner keeps the counter until the parked jobs end, so it is still there to unlock; they are queued after
+    for (auto &task: ready)
+    {
+        push(task);
+    }
+}
+
+void JobSystem::wait(Counter &counter)
+{
+    size_t index = queueIndex();
+    while (!counter.done())
+    {
+        if (!runOne(index))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::runOne(size_t index)
+{
+    Job job{};
+    bool found = false;
+    {
+        auto &q = *queues[index];
+        std::lock_guard lock(q.mutex);
+        if (!q.empty())
+        {
+            job = q.popBack();
+            found = true;
+        }
+    }
+    for (size_t k = 1; !found && k < queues.size(); ++k)
+    {
+        auto &q = *queues[(index + k) % queues.size()];
+        std::lock_guard lock(q.mutex);
+        if (!q.empty())
+        {
+            job = q.popFront();
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+    queued.fetch_sub(1);
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(Job &job)
+{
+    // A task of run lives in the job, which was copied since it was pushed
+    job.call(job.ctx ? job.ctx : job.storage.data(), job.begin, job.end);
+    if (job.counter)
+    {
+        finish(*job.counter);
+    }
+}
+
+void JobSystem::Queue::grow()
+{
+    std::vector<Job> larger(ring.size() * 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        larger[i] = ring[(head + i) % ring.size()];
+    }
+    ring.swap(larger);
+    head = 0;
+}
+
+void JobSystem::Queue::pushBack(const Job &job)
+{
+    if (count == ring.size())
+    {
+        grow();
+    }
+    ring[(head + count++) % ring.size()] = job;
+}
+
+JobSystem::Job JobSystem::Queue::popBack()
+{
+    return ring[(head + --count) % ring.size()];
+}
+
+JobSystem::Job JobSystem::Queue::popFront()
+{
+    auto job = ring[head];
+    head = (head + 1) % ring.size();
+    --count;
+    return job;
+}
@@ -0,0 +1,258 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_JOBSYSTEM_H
+#define CG_JOBSYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <array>
+#include <cstddef>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Persistent pool of worker threads running small jobs, shared by the rendering stages.
+ * Every worker owns a double ended queue: it pushes and pops its own jobs at the back, and when it runs out it steals
+ * from the front of the others, so a stage split in many ranges balances itself without a central queue. Threads
+ * calling in from outside the pool (the main thread) push to a queue of their own and run jobs too while they wait,
+ * so the caller is never idle and a pool of n threads has n - 1 workers.
+ * Completion is tracked with counters: a job submitted with a counter increments it and decrements it when it ends,
+ * and a job can wait for a counter to reach zero before it starts. A job submitted before its dependency is done
+ * is parked on the dependency's counter and queued by the job taking it to zero, so no thread pops or spins on a job
+ * that can't run, and dependencies cost nothing to jobs without one.
+ */
+class JobSystem
+{
+    struct Job;
+
+public:
+    /**
+     * Number of jobs not finished yet among those submitted with it.
+     * A counter must outlive the jobs counting on it and those depending on it.
+     */
+    class Counter
+    {
+    public:
+        [[nodiscard]] inline bool done() const
+        {
+            return pending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        friend class JobSystem;
+
+        /**
+         * Set in pending while jobs are parked, so that the job taking the count to zero queues them
+         */
+        static constexpr size_t parkedFlag = ~(~size_t(0) >> 1);
+
+        std::atomic<size_t> pending{0};
+        std::mutex parkMutex;
+        /**
+         * Tasks waiting for the counter to be done
+         */
+        std::vector<Job> parked;
+    };
+
+    /**
+     * @param threadCount threads working on jobs, the calling thread included; 0 uses one per hardware thread
+     * @param pinThreads bind worker i to core i modulo the number of cores
+     */
+    explicit JobSystem(unsigned threadCount = 0, bool pinThreads = false);
+
+    JobSystem(const JobSystem &) = delete;
+
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    ~JobSystem();
+
+    /**
+     * Threads working on jobs, the calling thread included
+     */
+    [[nodiscard]] inline unsigned getThreadCount() const
+    {
+        return static_cast<unsigned>(workers.size()) + 1;
+    }
+
+    /**
+     * Queue job, a callable stored in the job itself, so it must be trivially copyable and at most taskCapacity bytes,
+     * e.g. a lambda capturing a few references or values
+     * @param job called with no argument
+     * @param counter incremented now and decremented when job ends, may be null
+     * @param dependency job starts once this counter is done, may be null
+     */
+    template<typename F>
+    void run(F job, Counter *counter = nullptr, Counter *dependency = nullptr)
+    {
+        static_assert(sizeof(F) <= taskCapacity && alignof(F) <= alignof(std::max_align_t),
+                      "capture less, or by reference");
+        static_assert(std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>,
+                      "jobs are copied as bytes: capture by reference or trivially copyable values");
+        Job task{};
+        task.call = [](const void *ctx, size_t, size_t)
+        {
+            (*std::launder(static_cast<F *>(const_cast<void *>(ctx))))();
+        };
+        new(task.storage.data()) F(job);
+        submit(task, counter, dependency);
+    }
+
+    /**
+     * Run queued jobs until counter is done
+     */
+    void wait(Counter &counter);
+
+    /**
+     * Call f(rangeBegin, rangeEnd) over consecutive ranges of at most grain items covering [begin, end), in parallel,
+     * and return when all of them have returned. Runs inline when there is a single range or a single thread.
+     */
+    template<typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F &&f)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        grain = std::max<size_t>(grain, 1);
+        if (end - begin <= grain || workers.empty())
+        {
+            f(begin, end);
+            return;
+        }
+        Counter counter;
+        auto call = [](const void *ctx, size_t b, size_t e)
+        {
+            (*static_cast<std::remove_reference_t<F> *>(const_cast<void *>(ctx)))(b, e);
+        };
+        pushRanges(call, &f, begin, end, grain, counter);
+        wait(counter);
+    }
+
+    /**
+     * Call f(rangeBegin, rangeEnd) over about one range per thread covering [begin, end)
+     */
+    template<typename F>
+    void parallelFor(size_t begin, size_t end, F &&f)
+    {
+        size_t ranges = static_cast<size_t>(getThreadCount()) * 4;
+        parallelFor(begin, end, (end - begin + ranges - 1) / ranges, std::forward<F>(f));
+    }
+
+    /**
+     * Pool used by the renderer unless told otherwise, with one thread per hardware thread.
+     * Made on first use.
+     */
+    static JobSystem &shared();
+
+    /**
+     * System without workers, whose parallelFor runs inline in the caller: any number of threads can use it at once,
+     * e.g. to render frames that are already spread one per thread without splitting them further
+     */
+    static JobSystem &serial();
+
+    /**
+     * Largest callable run takes
+     */
+    static constexpr size_t taskCapacity = 6 * sizeof(void *);
+
+private:
+    /**
+     * Either call(ctx, begin, end) over a range of a parallelFor, or, when ctx is null, a task of run stored in the
+     * job and called as call(storage)
+     */
+    struct Job
+    {
+        void (*call)(const void *ctx, size_t begin, size_t end);
+        const void *ctx;
+        size_t begin, end;
+        Counter *counter;
+        alignas(std::max_align_t) std::array<unsigned char, taskCapacity> storage;
+    };
+
+    /**
+     * Jobs in a ring that doubles when full and never shrinks, so once it has held the largest backlog, pushing and
+     * popping don't allocate
+     */
+    struct Queue
+    {
+        std::mutex mutex;
+        std::vector<Job> ring = std::vector<Job>(64);
+        size_t head = 0;
+        size_t count = 0;
+
+        [[nodiscard]] inline bool empty() const
+        {
+            return count == 0;
+        }
+
+        void pushBack(const Job &job);
+
+        Job popBack();
+
+        Job popFront();
+
+        void grow();
+    };
+
+    std::vector<std::thread> workers;
+    /**
+     * Queue 0 is shared by the threads outside the pool, queue i by worker i
+     */
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> queued{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    /**
+     * Run jobs until stopping, after counting down started once the thread is set up
+     */
+    void workerLoop(unsigned index, bool pin, std::latch &started);
+
+    /**
+     * Index of the queue of the calling thread
+     */
+    [[nodiscard]] size_t queueIndex() const;
+
+    void push(const Job &job);
+
+    /**
+     * Count task on counter, then queue it, or park it until dependency is done
+     */
+    void submit(Job &task, Counter *counter, Counter *dependency);
+
+    /**
+     * Park task on dependency unless it is done
+     * @return false if dependency is done, and task must be queued
+     */
+    static bool park(Counter &dependency, const Job &task);
+
+    /**
+     * Count a job of counter as ended, and queue the jobs parked on it if it is done
+     */
+    void finish(Counter &counter);
+
+    void pushRanges(void (*call)(const void *, size_t, size_t), const void *ctx, size_t begin, size_t end,
+                    size_t grain, Counter &counter);
+
+    void notify(size_t jobs);
+
+    /**
+     * Pop from the queue of index, or steal from the others
+     * @return false if every queue was empty
+     */
+    bool runOne(size_t index);
+
+    void execute(Job &job);
+};
+
+#endif //CG_JOBSYSTEM_H
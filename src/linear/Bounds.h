@@ -0,0 +1,236 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_BOUNDS_H
+#define CG_BOUNDS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <span>
+#include "Vec.h"
+#include "Mat.h"
+#include "Affine.h"
+
+/**
+ * Axis aligned bounding box. A default box is empty: min above max, so that expanding it by a point gives that point.
+ */
+struct AABB
+{
+    Vec3 min{std::numeric_limits<Real>::max(), std::numeric_limits<Real>::max(), std::numeric_limits<Real>::max()};
+    Vec3 max{std::numeric_limits<Real>::lowest(), std::numeric_limits<Real>::lowest(),
+             std::numeric_limits<Real>::lowest()};
+
+    static AABB of(std::span<const Vec3> points)
+    {
+        AABB ret;
+        for (auto &p: points)
+        {
+            ret.expand(p);
+        }
+        return ret;
+    }
+
+    [[nodiscard]] inline bool empty() const
+    {
+        return min[0] > max[0];
+    }
+
+    inline void expand(const Vec3 &p)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            min[i] = std::min(min[i], p[i]);
+            max[i] = std::max(max[i], p[i]);
+        }
+    }
+
+    inline void expand(const AABB &other)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            min[i] = std::min(min[i], other.min[i]);
+            max[i] = std::max(max[i], other.max[i]);
+        }
+    }
+
+    [[nodiscard]] inline Vec3 center() const
+    {
+        return {(min[0] + max[0]) / 2, (min[1] + max[1]) / 2, (min[2] + max[2]) / 2};
+    }
+
+    [[nodiscard]] inline Vec3 extent() const
+    {
+        return {max[0] - min[0], max[1] - min[1], max[2] - min[2]};
+    }
+
+    [[nodiscard]] inline Real surfaceArea() const
+    {
+        auto e = extent();
+        return 2 * (e[0] * e[1] + e[1] * e[2] + e[2] * e[0]);
+    }
+
+    /**
+     * Box of the transformed box, from the center and the absolute linear part (Arvo), without transforming the
+     * 8 corners
+     * @param t
+     * @return
+     */
+    [[nodiscard]] AABB transformed(const Affine3 &t) const
+    {
+        if (empty())
+        {
+            return *this;
+        }
+        auto c = t.apply(center());
+        auto e = extent();
+        AABB ret;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            Real r = (std::abs(t.at(i, 0)) * e[0] + std::abs(t.at(i, 1)) * e[1] + std::abs(t.at(i, 2)) * e[2]) / 2;
+            ret.min[i] = c[i] - r;
+            ret.max[i] = c[i] + r;
+        }
+        return ret;
+    }
+};
+
+struct Sphere
+{
+    Vec3 center{0, 0, 0};
+    Real radius = -1;
+
+    /**
+     * Sphere around the box center: not the tightest, but computed in one pass
+     */
+    static Sphere of(std::span<const Vec3> points)
+    {
+        Sphere ret;
+        if (points.empty())
+        {
+            return ret;
+        }
+        ret.center = AABB::of(points).center();
+        Real r2 = 0;
+        for (auto &p: points)
+        {
+            auto d = p - ret.center;
+            r2 = std::max(r2, d.dot(d));
+        }
+        ret.radius = std::sqrt(r2);
+        return ret;
+    }
+
+    /**
+     * The radius grows by the largest scale of the linear part
+     */
+    [[nodiscard]] Sphere transformed(const Affine3 &t) const
+    {
+        Real scale = 0;
+        for (size_t j = 0; j < 3; ++j)
+        {
+            Real column = t.at(0, j) * t.at(0, j) + t.at(1, j) * t.at(1, j) + t.at(2, j) * t.at(2, j);
+            scale = std::max(scale, std::sqrt(column));
+        }
+        return {t.apply(center), radius * scale};
+    }
+};
+
+/**
+ * The six planes of the view volume, normals pointing inside and normalized, so a plane gives signed distances.
+ */
+class Frustum
+{
+public:
+    enum class Test
+    {
+        Outside, Intersect, Inside
+    };
+
+    Frustum() = default;
+
+    /**
+     * Planes of mtProj * mtCam, in world space
+     */
+    Frustum(const Mat4 &mtProj, const Mat4 &mtCam)
+            : Frustum(mtProj * mtCam, (mtProj * Vec4(0, 0, -1, 1))[3] < 0 ? -1 : 1) {}
+
+    /**
+     * Planes from a combined clip matrix (Gribb and Hartmann): a point is inside when -w <= x, y, z <= w.
+     * @param m
+     * @param wSign sign of w in front of the camera, -1 for makePerspectiveProjectTrans which keeps w = z
+     */
+    Frustum(const Mat4 &m, Real wSign)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+            {
+                planes[2 * i][j] = wSign * (m[3][j] + m[i][j]);
+                planes[2 * i + 1][j] = wSign * (m[3][j] - m[i][j]);
+            }
+        }
+        for (auto &p: planes)
+        {
+            Real len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            for (auto &v: p)
+            {
+                v /= len;
+            }
+        }
+    }
+
+    [[nodiscard]] inline const std::array<std::array<Real, 4>, 6> &getPlanes() const
+    {
+        return planes;
+    }
+
+    [[nodiscard]] Test test(const AABB &box) const
+    {
+        Test ret = Test::Inside;
+        for (auto &p: planes)
+        {
+            // Corner furthest along the normal, then the one furthest against it
+            Real far = p[3], near = p[3];
+            for (size_t i = 0; i < 3; ++i)
+            {
+                far += p[i] * (p[i] > 0 ? box.max[i] : box.min[i]);
+                near += p[i] * (p[i] > 0 ? box.min[i] : box.max[i]);
+            }
+            if (far < 0)
+            {
+                return Test::Outside;
+            }
+            if (near < 0)
+            {
+                ret = Test::Intersect;
+            }
+        }
+        return ret;
+    }
+
+    [[nodiscard]] Test test(const Sphere &sphere) const
+    {
+        Test ret = Test::Inside;
+        for (auto &p: planes)
+        {
+            Real d = p[0] * sphere.center[0] + p[1] * sphere.center[1] + p[2] * sphere.center[2] + p[3];
+            if (d < -sphere.radius)
+            {
+                return Test::Outside;
+            }
+            if (d < sphere.radius)
+            {
+                ret = Test::Intersect;
+            }
+        }
+        return ret;
+    }
+
+private:
+    std::array<std::array<Real, 4>, 6> planes{};
+};
+
+#endif //CG_BOUNDS_H
@@ -0,0 +1,152 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_FIXED_H
+#define CG_FIXED_H
+
+#include <cassert>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include "Vec.h"
+
+/**
+ * Signed fixed point number with F fractional bits in 32 bits, e.g. Fixed<4> is 28.4.
+ * Conversions from double round to nearest, so snapping is deterministic. Nothing saturates: a value out of range
+ * would be moved, which distorts whatever it is a vertex of, so callers keep values in range (the rasterizer clips
+ * to its guard band first) and conversions assert it.
+ * Products are computed in 64 bits before shifting back.
+ */
+template<int F>
+requires (F > 0 && F < 31)
+class Fixed
+{
+private:
+    static constexpr int32_t min = std::numeric_limits<int32_t>::min();
+    static constexpr int32_t max = std::numeric_limits<int32_t>::max();
+
+    int32_t value = 0;
+
+public:
+    static constexpr int fractionBits = F;
+    static constexpr int32_t one = 1 << F;
+
+    constexpr Fixed() = default;
+
+    /**
+     * The integer i, which must be within the range of the integer part
+     */
+    explicit constexpr Fixed(int i) : value(i * one)
+    {
+        assert(i >= min >> F && i <= max >> F && "out of fixed point range");
+    }
+
+    static constexpr Fixed fromRaw(int32_t raw)
+    {
+        Fixed ret;
+        ret.value = raw;
+        return ret;
+    }
+
+    /**
+     * The nearest number to d, which must be within range
+     */
+    static Fixed fromDouble(double d)
+    {
+        double scaled = std::round(d * one);
+        assert(scaled >= min && scaled <= max && "out of fixed point range");
+        return fromRaw(static_cast<int32_t>(scaled));
+    }
+
+    [[nodiscard]] constexpr int32_t raw() const
+    {
+        return value;
+    }
+
+    [[nodiscard]] constexpr double toDouble() const
+    {
+        return static_cast<double>(value) / one;
+    }
+
+    /**
+     * Largest integer not greater than the number
+     */
+    [[nodiscard]] constexpr int floor() const
+    {
+        return value >> F;
+    }
+
+    /**
+     * Smallest integer not less than the number
+     */
+    [[nodiscard]] constexpr int ceil() const
+    {
+        return static_cast<int>((static_cast<int64_t>(value) + one - 1) >> F);
+    }
+
+    constexpr Fixed operator-() const
+    {
+        return fromRaw(-value);
+    }
+
+    friend constexpr Fixed operator+(Fixed l, Fixed r)
+    {
+        return fromRaw(l.value + r.value);
+    }
+
+    friend constexpr Fixed operator-(Fixed l, Fixed r)
+    {
+        return fromRaw(l.value - r.value);
+    }
+
+    friend constexpr Fixed operator*(Fixed l, Fixed r)
+    {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(l.value) * r.value) >> F));
+    }
+
+    friend constexpr Fixed operator/(Fixed l, Fixed r)
+    {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(l.value) << F) / r.value));
+    }
+
+    constexpr Fixed &operator+=(Fixed other)
+    {
+        value += other.value;
+        return *this;
+    }
+
+    constexpr Fixed &operator-=(Fixed other)
+    {
+        value -= other.value;
+        return *this;
+    }
+
+    constexpr Fixed &operator*=(Fixed other)
+    {
+        return *this = *this * other;
+    }
+
+    constexpr Fixed &operator/=(Fixed other)
+    {
+        return *this = *this / other;
+    }
+
+    friend constexpr auto operator<=>(Fixed l, Fixed r) = default;
+
+    friend std::ostream &operator<<(std::ostream &os, Fixed f)
+    {
+        os << f.toDouble();
+        return os;
+    }
+};
+
+/**
+ * Screen space precision of the rasterizer: 1/16 of a pixel
+ */
+typedef Fixed<4> Fixed28p4;
+typedef Vec<Fixed28p4, 2> FVec2;
+
+#endif //CG_FIXED_H
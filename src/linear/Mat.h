@@ -88,7 +88,7 @@ public:
 
     Mat<T, M - 1, N - 1> remainMat(size_t i, size_t j) const;
 
-    [[nodiscard]] double determinant() const;
+    [[nodiscard]] T determinant() const;
 
     /**
      * Return the card of the matrix
@@ -131,14 +131,14 @@ public:
 
     Mat(std::initializer_list<T> initList) : value(*(initList.begin())) {}
 
-    double determinant() const
+    T determinant() const
     {
         return value;
     }
 };
 
-typedef Mat<double, 3, 3> Mat3;
-typedef Mat<double, 4, 4> Mat4;
+typedef Mat<Real, 3, 3> Mat3;
+typedef Mat<Real, 4, 4> Mat4;
 
 
 template<typename T, size_t M, size_t N>
@@ -428,13 +428,13 @@ noexcept
 
 template<typename T, size_t M, size_t N>
 requires (M > 0 && N > 0)
-double Mat<T, M, N>::determinant() const
+T Mat<T, M, N>::determinant() const
 {
     static_assert(M == N, "Only square matrices have determinant!");
 #if M == 2
     return mat[0][0] * mat[1][1] - mat[1][0] * mat[0][1];
 #else
-    double res = 0;
+    T res = 0;
     for (size_t i = 0; i != M; ++i)
     {
         res += (i & 1 ? -1 : 1) * mat[0][i] * remainMat(0, i).determinant();
@@ -456,27 +456,27 @@ size_t card() { return 0; };
 
 static inline Mat4 makeViewportTrans(int nx, int ny)
 {
-    auto _nx = static_cast<double>(nx), _ny = static_cast<double>(ny);
-    return Mat4({_nx / 2.0, 0, 0, (_nx - 1) / 2.0,
-                 0, _ny / 2.0, 0, (_ny - 1) / 2.0,
+    auto _nx = static_cast<Real>(nx), _ny = static_cast<Real>(ny);
+    return Mat4({_nx / 2, 0, 0, (_nx - 1) / 2,
+                 0, _ny / 2, 0, (_ny - 1) / 2,
                  0, 0, 1, 0,
                  0, 0, 0, 1});
 }
 
-static inline Mat4 makeOrthographicProjectTrans(double l, double b, double n, double r, double t, double f)
+static inline Mat4 makeOrthographicProjectTrans(Real l, Real b, Real n, Real r, Real t, Real f)
 {
     assert(r != l && t != b && f < n);
-    return Mat4({2.0 / (r - l), 0, 0, -(r + l) / (r - l), 0, 2.0 / (t - b), 0, -(t + b) / (t - b), 0, 0, 2.0 / (n - f),
+    return Mat4({2 / (r - l), 0, 0, -(r + l) / (r - l), 0, 2 / (t - b), 0, -(t + b) / (t - b), 0, 0, 2 / (n - f),
                  -(n + f) / (n - f), 0, 0, 0, 1});
 }
 
-static inline Mat4 makePerspectiveProjectTrans(double l, double b, double n, double r, double t, double f)
+static inline Mat4 makePerspectiveProjectTrans(Real l, Real b, Real n, Real r, Real t, Real f)
 {
     assert(r != l && t != b && f < n && n < 0);
     return Mat4({
-                        2.0 * n / (r - l), 0, (r + l) / (l - r), 0,
-                        0, 2.0 * n / (t - b), (t + b) / (b - t), 0,
-                        0, 0, (n + f) / (n - f), 2.0 * n * f / (f - n),
+                        2 * n / (r - l), 0, (r + l) / (l - r), 0,
+                        0, 2 * n / (t - b), (t + b) / (b - t), 0,
+                        0, 0, (n + f) / (n - f), 2 * n * f / (f - n),
                         0, 0, 1, 0});
 }
 
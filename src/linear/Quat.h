@@ -0,0 +1,196 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_QUAT_H
+#define CG_QUAT_H
+
+#include <cmath>
+#include <ostream>
+#include "Vec.h"
+#include "Mat.h"
+
+/**
+ * Quaternion w + xi + yj + zk. Unit quaternions represent rotations: they compose in 16 multiplications instead of
+ * the 27 of a 3x3 product, stay easy to renormalize, and can be interpolated with slerp.
+ */
+template<typename T>
+class Quat
+{
+private:
+    T w = 1, x = 0, y = 0, z = 0;
+
+public:
+    /**
+     * Identity rotation
+     */
+    constexpr Quat() = default;
+
+    constexpr Quat(T w, T x, T y, T z) : w(w), x(x), y(y), z(z) {}
+
+    /**
+     * Rotation of angle radians around axis, counter-clockwise when looking against the axis
+     * @param axis need not be normalized
+     * @param angle
+     */
+    static Quat fromAxisAngle(const Vec<T, 3> &axis, T angle)
+    {
+        auto n = axis.normalized();
+        T s = std::sin(angle / 2);
+        return {std::cos(angle / 2), n[0] * s, n[1] * s, n[2] * s};
+    }
+
+    /**
+     * Rotation of an orthonormal matrix with determinant 1
+     * @param m
+     * @return
+     */
+    static Quat fromMat3(const Mat<T, 3, 3> &m)
+    {
+        // Branch on the largest diagonal term so the square root stays away from 0
+        T trace = m[0][0] + m[1][1] + m[2][2];
+        if (trace > 0)
+        {
+            T s = std::sqrt(trace + 1) * 2;
+            return {s / 4, (m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s};
+        }
+        if (m[0][0] > m[1][1] && m[0][0] > m[2][2])
+        {
+            T s = std::sqrt(1 + m[0][0] - m[1][1] - m[2][2]) * 2;
+            return {(m[2][1] - m[1][2]) / s, s / 4, (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s};
+        }
+        if (m[1][1] > m[2][2])
+        {
+            T s = std::sqrt(1 + m[1][1] - m[0][0] - m[2][2]) * 2;
+            return {(m[0][2] - m[2][0]) / s, (m[0][1] + m[1][0]) / s, s / 4, (m[1][2] + m[2][1]) / s};
+        }
+        T s = std::sqrt(1 + m[2][2] - m[0][0] - m[1][1]) * 2;
+        return {(m[1][0] - m[0][1]) / s, (m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, s / 4};
+    }
+
+    [[nodiscard]] inline T getW() const
+    {
+        return w;
+    }
+
+    [[nodiscard]] inline T getX() const
+    {
+        return x;
+    }
+
+    [[nodiscard]] inline T getY() const
+    {
+        return y;
+    }
+
+    [[nodiscard]] inline T getZ() const
+    {
+        return z;
+    }
+
+    [[nodiscard]] T dot(const Quat &other) const
+    {
+        return w * other.w + x * other.x + y * other.y + z * other.z;
+    }
+
+    [[nodiscard]] T length() const
+    {
+        return std::sqrt(dot(*this));
+    }
+
+    [[nodiscard]] Quat normalized() const
+    {
+        T inv = 1 / length();
+        return {w * inv, x * inv, y * inv, z * inv};
+    }
+
+    /**
+     * The inverse of a unit quaternion
+     */
+    [[nodiscard]] Quat conjugate() const
+    {
+        return {w, -x, -y, -z};
+    }
+
+    [[nodiscard]] Quat inverse() const
+    {
+        T inv = 1 / dot(*this);
+        return {w * inv, -x * inv, -y * inv, -z * inv};
+    }
+
+    /**
+     * Hamilton product: l * r rotates by r first, then by l
+     */
+    friend Quat operator*(const Quat &l, const Quat &r)
+    {
+        return {l.w * r.w - l.x * r.x - l.y * r.y - l.z * r.z,
+                l.w * r.x + l.x * r.w + l.y * r.z - l.z * r.y,
+                l.w * r.y - l.x * r.z + l.y * r.w + l.z * r.x,
+                l.w * r.z + l.x * r.y - l.y * r.x + l.z * r.w};
+    }
+
+    /**
+     * Rotate v by this unit quaternion, as v + 2w(q x v) + 2q x (q x v)
+     * @param v
+     * @return
+     */
+    [[nodiscard]] Vec<T, 3> rotate(const Vec<T, 3> &v) const
+    {
+        T tx = 2 * (y * v[2] - z * v[1]), ty = 2 * (z * v[0] - x * v[2]), tz = 2 * (x * v[1] - y * v[0]);
+        return {v[0] + w * tx + (y * tz - z * ty), v[1] + w * ty + (z * tx - x * tz), v[2] + w * tz + (x * ty - y * tx)};
+    }
+
+    /**
+     * Rotation matrix of this unit quaternion
+     * @return
+     */
+    [[nodiscard]] Mat<T, 3, 3> toMat3() const
+    {
+        T xx = x * x, yy = y * y, zz = z * z, xy = x * y, xz = x * z, yz = y * z, wx = w * x, wy = w * y, wz = w * z;
+        return Mat<T, 3, 3>({1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy),
+                             2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx),
+                             2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy)});
+    }
+
+    /**
+     * Spherical interpolation between unit quaternions along the shorter arc, at constant angular speed
+     * @param a
+     * @param b
+     * @param t in [0, 1]
+     * @return
+     */
+    static Quat slerp(const Quat &a, Quat b, T t)
+    {
+        T cosTheta = a.dot(b);
+        if (cosTheta < 0)
+        {
+            b = {-b.w, -b.x, -b.y, -b.z};
+            cosTheta = -cosTheta;
+        }
+        T ka, kb;
+        if (cosTheta > static_cast<T>(0.9995))
+        {
+            // Nearly parallel: sin(theta) vanishes, fall back to a normalized lerp
+            ka = 1 - t;
+            kb = t;
+        } else
+        {
+            T theta = std::acos(cosTheta), inv = 1 / std::sin(theta);
+            ka = std::sin((1 - t) * theta) * inv;
+            kb = std::sin(t * theta) * inv;
+        }
+        return Quat{ka * a.w + kb * b.w, ka * a.x + kb * b.x, ka * a.y + kb * b.y, ka * a.z + kb * b.z}.normalized();
+    }
+
+    friend bool operator==(const Quat &l, const Quat &r) = default;
+
+    friend std::ostream &operator<<(std::ostream &os, const Quat &q)
+    {
+        os << "(" << q.w << ", " << q.x << ", " << q.y << ", " << q.z << ")";
+        return os;
+    }
+};
+
+typedef Quat<Real> Quaternion;
+
+#endif //CG_QUAT_H
@@ -0,0 +1,27 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_REAL_H
+#define CG_REAL_H
+
+#include <type_traits>
+
+/**
+ * Scalar type of Vec3, Vec4, Mat3, Mat4 and the renderer's interpolation.
+ * Configure with -DCG_FLOAT_PRECISION=ON to render in float: half the memory traffic per vertex and twice the
+ * SIMD lanes, at the cost of about 7 significant digits.
+ */
+#ifdef CG_FLOAT_PRECISION
+typedef float Real;
+#else
+typedef double Real;
+#endif
+
+/**
+ * Type results like lengths are computed in: T itself when it is floating point, double otherwise
+ */
+template<typename T>
+using FloatOf = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+#endif //CG_REAL_H
@@ -13,6 +13,8 @@
 #include "sstream"
 #include "array"
 #include "algorithm"
+#include "cassert"
+#include "Real.h"
 
 template<typename T, size_t M, size_t N> requires (M > 0 && N > 0)
 class Mat;
@@ -71,13 +73,13 @@ public:
      * getLength
      * @return
      */
-    [[nodiscard]] double length() const;
+    [[nodiscard]] FloatOf<T> length() const;
 
     /**
      * get normalized
      * @return
      */
-    [[nodiscard]] Vec<double, N> normalized() const;
+    [[nodiscard]] Vec<FloatOf<T>, N> normalized() const;
 
     /*
      * get negative();
@@ -271,12 +273,12 @@ Vec<T, N> Vec<T, N>::plus(const Vec<T, N> &other) const
  */
 template<typename T, size_t N>
 requires (N > 0)
-double Vec<T, N>::length() const
+FloatOf<T> Vec<T, N>::length() const
 {
-    double ret = 0;
+    FloatOf<T> ret = 0;
     for (auto &i: arr)
     {
-        ret += std::pow(i, 2);
+        ret += static_cast<FloatOf<T>>(i) * static_cast<FloatOf<T>>(i);
     }
     return std::sqrt(ret);
 }
@@ -287,15 +289,15 @@ double Vec<T, N>::length() const
  */
 template<typename T, size_t N>
 requires (N > 0)
-[[nodiscard]] Vec<double, N> Vec<T, N>::normalized() const
+[[nodiscard]] Vec<FloatOf<T>, N> Vec<T, N>::normalized() const
 {
-    double len = length();
-    std::array<T, N> newArr;
+    FloatOf<T> len = length();
+    std::array<FloatOf<T>, N> newArr;
     for (size_t i = 0; i < N; ++i)
     {
-        newArr[i] = arr[i] / len;
+        newArr[i] = static_cast<FloatOf<T>>(arr[i]) / len;
     }
-    return Vec<double, N>(newArr);
+    return Vec<FloatOf<T>, N>(newArr);
 }
 
 /*
@@ -452,8 +454,9 @@ Vec<T, N>::Vec(const Vec<T, M> &other, Ts...rest)
 }
 
 
-template<size_t N>
-static Vec<int, N> round(const Vec<double, N> &vec)
+template<typename T, size_t N>
+requires std::is_floating_point_v<T>
+static Vec<int, N> round(const Vec<T, N> &vec)
 {
     Vec<int, N> ret;
     for (int i = 0; i < N; i++)
@@ -463,9 +466,20 @@ static Vec<int, N> round(const Vec<double, N> &vec)
     return ret;
 }
 
+/**
+ * Twice the signed area of the triangle (a, b, c) in the xy plane: positive when counter-clockwise, zero when the
+ * points are collinear. The sign is exact whenever T's arithmetic is, e.g. for Number.
+ */
+template<typename T, size_t N>
+requires (N >= 2)
+T orient2d(const Vec<T, N> &a, const Vec<T, N> &b, const Vec<T, N> &c)
+{
+    return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
 typedef Vec<int, 2> iVec2;
-typedef Vec<double, 3> Vec3;
+typedef Vec<Real, 3> Vec3;
 typedef Vec<int, 3> iVec3;
-typedef Vec<double, 4> Vec4;
+typedef Vec<Real, 4> Vec4;
 
 #endif //CG_VEC_H
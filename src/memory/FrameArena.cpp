@@ -0,0 +1,141 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <new>
+#include "FrameArena.h"
+
+namespace
+{
+    std::atomic<uint64_t> serials{0};
+
+    /**
+     * Frame arena the calling thread used last, and its sub-arena there
+     */
+    struct LastUse
+    {
+        uint64_t serial = 0;
+        Arena *arena = nullptr;
+    };
+
+    thread_local LastUse lastUse;
+}
+
+Arena::~Arena()
+{
+    freeBlocks();
+}
+
+void Arena::addBlock(size_t size)
+{
+    auto data = static_cast<std::byte *>(::operator new(size, std::align_val_t(blockAlignment)));
+    blocks.push_back({data, size});
+}
+
+void Arena::freeBlocks()
+{
+    for (auto &b: blocks)
+    {
+        ::operator delete(b.data, std::align_val_t(blockAlignment));
+    }
+    blocks.clear();
+}
+
+void *Arena::allocate(size_t bytes, size_t alignment)
+{
+    assert(alignment <= blockAlignment && (alignment & (alignment - 1)) == 0);
+    while (current < blocks.size())
+    {
+        size_t start = (offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes <= blocks[current].size)
+        {
+            offset = start + bytes;
+            return blocks[current].data + start;
+        }
+        ++current;
+        offset = 0;
+    }
+    addBlock(std::max(blockSize, bytes));
+    offset = bytes;
+    return blocks[current].data;
+}
+
+void Arena::reset()
+{
+    if (blocks.size() > 1)
+    {
+        size_t total = 0;
+        for (auto &b: blocks)
+        {
+            total += b.size;
+        }
+        freeBlocks();
+        addBlock(total);
+    }
+    current = 0;
+    offset = 0;
+}
+
+size_t Arena::getUsed() const
+{
+    size_t used = 0;
+    for (size_t i = 0; i < current && i < blocks.size(); ++i)
+    {
+        used += blocks[i].size;
+    }
+    return used + offset;
+}
+
+size_t Arena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (auto &b: blocks)
+    {
+        capacity += b.size;
+    }
+    return capacity;
+}
+
+FrameArena::FrameArena() : serial(++serials) {}
+
+Arena &FrameArena::local()
+{
+    if (lastUse.serial == serial)
+    {
+        return *lastUse.arena;
+    }
+    std::lock_guard lock(mutex);
+    auto id = std::this_thread::get_id();
+    auto it = std::find(owners.begin(), owners.end(), id);
+    if (it == owners.end())
+    {
+        owners.push_back(id);
+        arenas.push_back(std::make_unique<Arena>());
+        it = owners.end() - 1;
+    }
+    lastUse = {serial, arenas[it - owners.begin()].get()};
+    return *lastUse.arena;
+}
+
+void FrameArena::reset()
+{
+    std::lock_guard lock(mutex);
+    for (auto &a: arenas)
+    {
+        a->reset();
+    }
+}
+
+size_t FrameArena::getUsed() const
+{
+    std::lock_guard lock(mutex);
+    size_t used = 0;
+    for (auto &a: arenas)
+    {
+        used += a->getUsed();
+    }
+    return used;
+}
@@ -0,0 +1,131 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_FRAMEARENA_H
+#define CG_FRAMEARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Linear allocator: allocating bumps an offset in a block, and reset() frees everything at once.
+ * Nothing is destroyed, so it only holds trivially destructible types. Blocks are kept across resets, and a reset
+ * after the blocks overflowed merges them into one block of their total size, so once the largest frame has been
+ * seen, allocating never reaches the heap and reset only rewinds the offset.
+ */
+class Arena
+{
+public:
+    static constexpr size_t blockAlignment = 64;
+
+    /**
+     * @param blockSize size of the first block, and the least size of a block added when it overflows
+     */
+    explicit Arena(size_t blockSize = size_t(1) << 16) : blockSize(blockSize) {}
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena();
+
+    /**
+     * @param alignment power of two, at most blockAlignment
+     * @return uninitialized storage valid until the next reset
+     */
+    void *allocate(size_t bytes, size_t alignment);
+
+    /**
+     * Array of count default-initialized T: left uninitialized for scalars, default constructed for classes
+     */
+    template<typename T>
+    std::span<T> allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is released without destroying");
+        auto p = static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+        std::uninitialized_default_construct_n(p, count);
+        return {p, count};
+    }
+
+    /**
+     * Free everything allocated
+     */
+    void reset();
+
+    /**
+     * Bytes allocated since the last reset, alignment padding included
+     */
+    [[nodiscard]] size_t getUsed() const;
+
+    [[nodiscard]] size_t getCapacity() const;
+
+private:
+    struct Block
+    {
+        std::byte *data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t blockSize;
+    /**
+     * Block allocated from, and offset in it
+     */
+    size_t current = 0;
+    size_t offset = 0;
+
+    void addBlock(size_t size);
+
+    void freeBlocks();
+};
+
+/**
+ * Arena of the transient data of a frame, with a sub-arena per thread, so that jobs allocate without sharing a lock
+ * or a cache line.
+ * local() is a thread local lookup once a thread has used the frame arena; reset() must not run while another thread
+ * allocates, and rewinds every sub-arena.
+ * Its data being transient, a copy starts empty and an assignment leaves the arena as it is, so that the objects
+ * holding one stay copyable.
+ */
+class FrameArena
+{
+public:
+    FrameArena();
+
+    FrameArena(const FrameArena &) : FrameArena() {}
+
+    FrameArena &operator=(const FrameArena &)
+    {
+        return *this;
+    }
+
+    /**
+     * Sub-arena of the calling thread, made on its first use
+     */
+    Arena &local();
+
+    void reset();
+
+    /**
+     * Bytes used by all the sub-arenas since the last reset
+     */
+    [[nodiscard]] size_t getUsed() const;
+
+private:
+    /**
+     * Unique for the process, so a thread never mistakes a new frame arena for a destroyed one at the same address
+     */
+    uint64_t serial;
+    mutable std::mutex mutex;
+    std::vector<std::thread::id> owners;
+    std::vector<std::unique_ptr<Arena>> arenas;
+};
+
+#endif //CG_FRAMEARENA_H
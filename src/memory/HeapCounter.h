@@ -0,0 +1,17 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_HEAPCOUNTER_H
+#define CG_HEAPCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * Calls of the global operator new in the process so far, array and aligned forms included.
+ * Counted by replacements of the global operator new and delete that only the programs linking the cgheapcount
+ * target get, to check that a steady state loop allocates nothing: take the count before and after.
+ */
+uint64_t heapAllocations();
+
+#endif //CG_HEAPCOUNTER_H
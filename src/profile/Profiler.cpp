@@ -0,0 +1,273 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include "Profiler.h"
+
+using namespace std;
+
+namespace
+{
+    using Clock = chrono::steady_clock;
+
+    struct Event
+    {
+        const char *name;
+        Clock::time_point start, end;
+    };
+
+    /**
+     * Slot of the event ring. Fields are atomic only so that readers may race with the owner overwriting them;
+     * relaxed, they compile to plain moves.
+     */
+    struct EventSlot
+    {
+        atomic<const char *> name{nullptr};
+        atomic<Clock::rep> start{0}, end{0};
+    };
+
+    /**
+     * What one thread recorded. The events go to a ring allocated when the thread first records, so recording
+     * neither allocates nor locks; once full, each event overwrites the oldest. Only the owner writes. Readers
+     * check, after reading a slot, that the owner hadn't started overwriting it, as a seqlock reader does, and skip
+     * it otherwise.
+     */
+    struct ThreadData
+    {
+        uint32_t id = 0;
+        unique_ptr<EventSlot[]> events = make_unique<EventSlot[]>(Profiler::maxEvents);
+        /**
+         * Events ever recorded, and the count before the first one kept since the last clear
+         */
+        atomic<uint64_t> written{0};
+        atomic<uint64_t> cleared{0};
+        array<atomic<uint64_t>, Profiler::counterCount> counters{};
+
+        /**
+         * Call f(event) for the events kept, newest first, until it returns false
+         */
+        template<typename F>
+        void forEachNewest(F &&f) const
+        {
+            uint64_t end = written.load(memory_order_acquire);
+            uint64_t begin = max(cleared.load(memory_order_relaxed), end > Profiler::maxEvents ?
+                                                                     end - Profiler::maxEvents : 0);
+            for (uint64_t i = end; i-- > begin;)
+            {
+                auto &slot = events[i % Profiler::maxEvents];
+                Event e{slot.name.load(memory_order_relaxed), Clock::time_point(Clock::duration(
+                        slot.start.load(memory_order_relaxed))), Clock::time_point(Clock::duration(
+                        slot.end.load(memory_order_relaxed)))};
+                atomic_thread_fence(memory_order_acquire);
+                // Overwritten while read: so are all the older ones
+                if (written.load(memory_order_relaxed) >= i + Profiler::maxEvents)
+                {
+                    return;
+                }
+                if (!f(e))
+                {
+                    return;
+                }
+            }
+        }
+    };
+
+    struct Registry
+    {
+        mutex lock;
+        /**
+         * Kept after their thread exits, so its events still make the trace
+         */
+        vector<unique_ptr<ThreadData>> threads;
+        Clock::time_point epoch = Clock::now();
+        Clock::time_point frameStart = epoch;
+        uint64_t frame = 0;
+        array<uint64_t, Profiler::counterCount> counterBase{};
+    };
+
+    Registry &registry()
+    {
+        static Registry r;
+        return r;
+    }
+
+    ThreadData &local()
+    {
+        thread_local ThreadData *data = []
+        {
+            auto &r = registry();
+            lock_guard guard(r.lock);
+            r.threads.push_back(make_unique<ThreadData>());
+            r.threads.back()->id = static_cast<uint32_t>(r.threads.size());
+            return r.threads.back().get();
+        }();
+        return *data;
+    }
+
+    array<uint64_t, Profiler::counterCount> sumCounters(Registry &r)
+    {
+        array<uint64_t, Profiler::counterCount> sum{};
+        for (auto &t: r.threads)
+        {
+            for (size_t i = 0; i < sum.size(); ++i)
+            {
+                sum[i] += t->counters[i].load(memory_order_relaxed);
+            }
+        }
+        return sum;
+    }
+
+    constexpr const char *counterNames[] = {"triangles in", "triangles culled", "fragments tested",
+                                            "fragments passed", "pixels written", "bytes encoded"};
+
+    /**
+     * Escape name as the body of a JSON string
+     */
+    string jsonEscape(const char *name)
+    {
+        string out;
+        for (auto p = name; *p; ++p)
+        {
+            if (*p == '"' || *p == '\\')
+            {
+                out += '\\';
+            }
+            out += *p;
+        }
+        return out;
+    }
+}
+
+void Profiler::record(const char *name, Clock::time_point start, Clock::time_point end)
+{
+    auto &t = local();
+    uint64_t n = t.written.load(memory_order_relaxed);
+    auto &slot = t.events[n % maxEvents];
+    // A reader seeing the slot being overwritten also sees the count published before, and skips it
+    atomic_thread_fence(memory_order_release);
+    slot.name.store(name, memory_order_relaxed);
+    slot.start.store(start.time_since_epoch().count(), memory_order_relaxed);
+    slot.end.store(end.time_since_epoch().count(), memory_order_relaxed);
+    t.written.store(n + 1, memory_order_release);
+}
+
+void Profiler::count(ProfileCounter counter, uint64_t n)
+{
+    // Only this thread writes its counters: a plain add, atomic only so that reports can read them
+    auto &c = local().counters[static_cast<size_t>(counter)];
+    c.store(c.load(memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+void Profiler::attachThread()
+{
+    local();
+}
+
+void Profiler::beginFrame()
+{
+    auto &r = registry();
+    lock_guard guard(r.lock);
+    r.frameStart = Clock::now();
+    r.counterBase = sumCounters(r);
+}
+
+Profiler::FrameReport Profiler::endFrame()
+{
+    auto &r = registry();
+    lock_guard guard(r.lock);
+    auto end = Clock::now();
+    FrameReport report;
+    report.frame = r.frame++;
+    report.ms = chrono::duration<double, milli>(end - r.frameStart).count();
+    auto sum = sumCounters(r);
+    for (size_t i = 0; i < sum.size(); ++i)
+    {
+        report.counters[i] = sum[i] - r.counterBase[i];
+    }
+    for (auto &t: r.threads)
+    {
+        // Events are recorded as scopes end, so the frame's are the newest
+        t->forEachNewest([&](const Event &e)
+                         {
+                             if (e.end < r.frameStart)
+                             {
+                                 return false;
+                             }
+                             auto stage = find_if(report.stages.begin(), report.stages.end(),
+                                                  [&](const Stage &s) { return s.name == e.name; });
+                             if (stage == report.stages.end())
+                             {
+                                 report.stages.push_back({e.name, 0, 0});
+                                 stage = report.stages.end() - 1;
+                             }
+                             ++stage->calls;
+                             stage->ms += chrono::duration<double, milli>(e.end - e.start).count();
+                             return true;
+                         });
+    }
+    sort(report.stages.begin(), report.stages.end(), [](const Stage &a, const Stage &b) { return a.ms > b.ms; });
+    r.frameStart = end;
+    r.counterBase = sum;
+    return report;
+}
+
+void Profiler::FrameReport::print(ostream &out) const
+{
+    auto flags = out.flags();
+    out << "frame " << frame << ": " << fixed << setprecision(3) << ms << " ms\n";
+    for (auto &s: stages)
+    {
+        out << "  " << left << setw(24) << s.name << right << setw(10) << s.ms << " ms" << setw(10) << s.calls
+            << " calls\n";
+    }
+    for (size_t i = 0; i < counterCount; ++i)
+    {
+        out << "  " << left << setw(24) << counterNames[i] << right << setw(13) << counters[i] << "\n";
+    }
+    out.flags(flags);
+}
+
+bool Profiler::writeChromeTrace(const char *filename)
+{
+    ofstream out(filename);
+    if (!out)
+    {
+        return false;
+    }
+    auto &r = registry();
+    lock_guard guard(r.lock);
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (auto &t: r.threads)
+    {
+        t->forEachNewest([&](const Event &e)
+                         {
+                             // Complete events, in microseconds since the first use of the profiler; the trace
+                             // viewers sort them
+                             out << (first ? "\n" : ",\n") << "{\"name\":\"" << jsonEscape(e.name)
+                                 << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t->id << ",\"ts\":"
+                                 << chrono::duration<double, micro>(e.start - r.epoch).count() << ",\"dur\":"
+                                 << chrono::duration<double, micro>(e.end - e.start).count() << "}";
+                             first = false;
+                             return true;
+                         });
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(out);
+}
+
+void Profiler::clear()
+{
+    auto &r = registry();
+    lock_guard guard(r.lock);
+    for (auto &t: r.threads)
+    {
+        t->cleared.store(t->written.load(memory_order_acquire), memory_order_relaxed);
+    }
+}
@@ -0,0 +1,134 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_PROFILER_H
+#define CG_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * Events counted along the pipeline
+ */
+enum class ProfileCounter : uint8_t
+{
+    TrianglesIn, TrianglesCulled, FragmentsTested, FragmentsPassed, PixelsWritten, BytesEncoded, Count
+};
+
+/**
+ * Scoped timers and counters of the render pipeline, gathered per frame and exportable as a Chrome trace.
+ * Every thread records into a fixed ring of its own, so recording takes no lock and, once a thread has recorded
+ * once, doesn't allocate; reports and exports read them all. The pipeline only records through the CG_PROFILE_* macros, which compile to nothing unless CG_PROFILE is
+ * defined (the CMake option of the same name), so a normal build pays nothing; the reporting side always exists
+ * and reports empty frames then.
+ * Timers use steady_clock: one read costs about 20 ns, and the timed scopes are a stage or a tile, not a pixel.
+ */
+class Profiler
+{
+public:
+    static constexpr size_t counterCount = static_cast<size_t>(ProfileCounter::Count);
+
+    struct Stage
+    {
+        const char *name;
+        uint64_t calls;
+        /**
+         * Summed over threads, so a parallel stage can take longer than the frame
+         */
+        double ms;
+    };
+
+    struct FrameReport
+    {
+        uint64_t frame = 0;
+        double ms = 0;
+        std::vector<Stage> stages;
+        std::array<uint64_t, counterCount> counters{};
+
+        [[nodiscard]] inline uint64_t get(ProfileCounter counter) const
+        {
+            return counters[static_cast<size_t>(counter)];
+        }
+
+        void print(std::ostream &out) const;
+    };
+
+    /**
+     * Times its own lifetime as one event named name, which must be a string literal
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(const char *name) : name(name), start(std::chrono::steady_clock::now()) {}
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope()
+        {
+            record(name, start, std::chrono::steady_clock::now());
+        }
+
+    private:
+        const char *name;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    static void record(const char *name, std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end);
+
+    static void count(ProfileCounter counter, uint64_t n);
+
+    /**
+     * Allocate the buffers of the calling thread now instead of at its first event, which for a worker of a pool
+     * may come in the middle of any frame
+     */
+    static void attachThread();
+
+    /**
+     * Start a frame: the next report covers what is recorded from now on
+     */
+    static void beginFrame();
+
+    /**
+     * Time per stage and counters since beginFrame
+     */
+    static FrameReport endFrame();
+
+    /**
+     * Write every event kept so far as Chrome trace event JSON, for chrome://tracing or Perfetto
+     * @return false if the file can't be written
+     */
+    static bool writeChromeTrace(const char *filename);
+
+    /**
+     * Drop the events kept for the trace. Each thread keeps its latest maxEvents.
+     */
+    static void clear();
+
+    static constexpr size_t maxEvents = size_t(1) << 16;
+};
+
+#ifdef CG_PROFILE
+#define CG_PROFILE_JOIN2(a, b) a##b
+#define CG_PROFILE_JOIN(a, b) CG_PROFILE_JOIN2(a, b)
+#define CG_PROFILE_SCOPE(name) Profiler::Scope CG_PROFILE_JOIN(profileScope, __LINE__)(name)
+#define CG_PROFILE_COUNT(counter, n) Profiler::count(ProfileCounter::counter, static_cast<uint64_t>(n))
+#define CG_PROFILE_THREAD() Profiler::attachThread()
+/**
+ * Statement kept only in profiled builds, to keep a local tally in a hot loop and count it once after
+ */
+#define CG_PROFILE_ONLY(statement) statement
+#else
+#define CG_PROFILE_SCOPE(name) ((void) 0)
+#define CG_PROFILE_COUNT(counter, n) ((void) 0)
+#define CG_PROFILE_THREAD() ((void) 0)
+#define CG_PROFILE_ONLY(statement)
+#endif
+
+#endif //CG_PROFILER_H
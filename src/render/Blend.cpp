@@ -0,0 +1,70 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <cstring>
+#include "Blend.h"
+
+namespace
+{
+    /**
+     * x / 255 rounded, exact up to 255 * 257; above, where the blends saturate anyway, it may be one off
+     */
+    inline unsigned div255(unsigned x)
+    {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    template<BlendMode Mode, int Bpp>
+    void blendSpan(unsigned char *__restrict dst, const TGAColor *__restrict src, size_t count)
+    {
+        for (size_t p = 0; p < count; ++p)
+        {
+            const unsigned char *s = src[p].raw;
+            unsigned char *d = dst + p * Bpp;
+            unsigned a = s[3];
+            unsigned ks = Mode == BlendMode::Premultiplied ? 255 : a;
+            unsigned kd = Mode == BlendMode::Additive ? 255 : 255 - a;
+            for (int c = 0; c < Bpp; ++c)
+            {
+                unsigned k = Bpp == 4 && c == 3 ? 255 : ks;
+                d[c] = static_cast<unsigned char>(std::min(255u, div255(s[c] * k + d[c] * kd)));
+            }
+        }
+    }
+
+    template<BlendMode Mode>
+    void blendSpan(unsigned char *dst, const TGAColor *src, size_t count, int bytespp)
+    {
+        switch (bytespp)
+        {
+            case 1:
+                return blendSpan<Mode, 1>(dst, src, count);
+            case 3:
+                return blendSpan<Mode, 3>(dst, src, count);
+            default:
+                return blendSpan<Mode, 4>(dst, src, count);
+        }
+    }
+}
+
+void blendSpan(BlendMode mode, unsigned char *dst, const TGAColor *src, size_t count, int bytespp)
+{
+    switch (mode)
+    {
+        case BlendMode::Replace:
+            for (size_t p = 0; p < count; ++p)
+            {
+                memcpy(dst + p * bytespp, src[p].raw, bytespp);
+            }
+            return;
+        case BlendMode::Over:
+            return blendSpan<BlendMode::Over>(dst, src, count, bytespp);
+        case BlendMode::Additive:
+            return blendSpan<BlendMode::Additive>(dst, src, count, bytespp);
+        case BlendMode::Premultiplied:
+            return blendSpan<BlendMode::Premultiplied>(dst, src, count, bytespp);
+    }
+}
@@ -0,0 +1,43 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_BLEND_H
+#define CG_BLEND_H
+
+#include <cstddef>
+#include "tgaimage/tgaimage.h"
+
+/**
+ * How a fragment of color s and alpha a combines with the pixel d under it, channels in [0, 255]:
+ * every mode is s * ks + d * kd with the factors below, saturated. The alpha channel of an RGBA target always takes
+ * s with a factor of 1, so it accumulates coverage.
+ */
+enum class BlendMode
+{
+    /**
+     * The fragment overwrites the pixel, alpha ignored
+     */
+    Replace,
+    /**
+     * ks = a, kd = 1 - a: straight alpha, the usual transparency
+     */
+    Over,
+    /**
+     * ks = a, kd = 1: light adding up, glows and particles
+     */
+    Additive,
+    /**
+     * ks = 1, kd = 1 - a: colors already multiplied by their alpha, so a fragment can both cover and add light
+     */
+    Premultiplied
+};
+
+/**
+ * Blend a span of count fragments into count consecutive pixels of dst, which has bytespp bytes per pixel.
+ * Runs one loop per mode and pixel size over the whole span with the factors in integers, which the compiler
+ * turns into vector code, instead of a call per pixel.
+ */
+void blendSpan(BlendMode mode, unsigned char *dst, const TGAColor *src, size_t count, int bytespp);
+
+#endif //CG_BLEND_H
@@ -0,0 +1,137 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cmath>
+#include "CommandBuffer.h"
+
+static inline bool isFinite(const Point &p)
+{
+    return std::isfinite(p[0]) && std::isfinite(p[1]) && std::isfinite(p[2]);
+}
+
+void CommandBuffer::setCamera(const Mat4 &mtProj, const Mat4 &mtCam)
+{
+    cameras.push_back({mtProj, mtCam});
+    commands.push_back({Op::SetCamera, static_cast<uint32_t>(cameras.size() - 1), nullptr, 0});
+}
+
+void CommandBuffer::setShadingMode(Image::ShadingMode mode)
+{
+    setState(Op::SetShadingMode, static_cast<uint32_t>(mode));
+}
+
+void CommandBuffer::setLineSmoothing(bool smooth)
+{
+    setState(Op::SetLineSmoothing, smooth);
+}
+
+void CommandBuffer::setState(CommandBuffer::Op op, uint32_t arg)
+{
+    for (auto i = commands.rbegin(); i != commands.rend(); ++i)
+    {
+        if (i->op == op)
+        {
+            if (i->arg == arg)
+            {
+                return;
+            }
+            break;
+        }
+    }
+    commands.push_back({op, arg, nullptr, 0});
+}
+
+void CommandBuffer::drawPoints(std::span<const Point> points)
+{
+    record(Op::DrawPoints, points, isFinite);
+}
+
+void CommandBuffer::drawLines(std::span<const Line> lines)
+{
+    record(Op::DrawLines, lines, [](const Line &l) { return isFinite(l.p1) && isFinite(l.p2); });
+}
+
+void CommandBuffer::drawTriangles(std::span<const Triangle> triangles)
+{
+    record(Op::DrawTriangles, triangles, [](const Triangle &t)
+    {
+        if (!isFinite(t.p1) || !isFinite(t.p2) || !isFinite(t.p3))
+        {
+            return false;
+        }
+        Vec3 e1 = t.p2.toVec3() - t.p1.toVec3(), e2 = t.p3.toVec3() - t.p1.toVec3();
+        return e1.cross(e2).dot(e1.cross(e2)) > 0;
+    });
+}
+
+template<typename T, typename Valid>
+void CommandBuffer::record(CommandBuffer::Op op, std::span<const T> items, Valid &&valid)
+{
+    size_t begin = 0;
+    auto flush = [&](size_t end)
+    {
+        if (begin == end)
+        {
+            return;
+        }
+        const T *first = items.data() + begin;
+        if (!commands.empty() && commands.back().op == op &&
+            static_cast<const T *>(commands.back().geometry) + commands.back().count == first)
+        {
+            commands.back().count += end - begin;
+        } else
+        {
+            commands.push_back({op, 0, first, end - begin});
+        }
+    };
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        if (!valid(items[i]))
+        {
+            flush(i);
+            begin = i + 1;
+        }
+    }
+    flush(items.size());
+}
+
+void CommandBuffer::clear()
+{
+    commands.clear();
+    cameras.clear();
+}
+
+void CommandBuffer::replay(Image &img, const Mat4 &mtProj, const Mat4 &mtCam) const
+{
+    img.setCamera(mtProj, mtCam);
+    replay(img);
+}
+
+void CommandBuffer::replay(Image &img) const
+{
+    for (auto &cmd: commands)
+    {
+        switch (cmd.op)
+        {
+            case Op::SetCamera:
+                img.setCamera(cameras[cmd.arg][0], cameras[cmd.arg][1]);
+                break;
+            case Op::SetShadingMode:
+                img.setShadingMode(static_cast<Image::ShadingMode>(cmd.arg));
+                break;
+            case Op::SetLineSmoothing:
+                img.setLineSmoothing(cmd.arg != 0);
+                break;
+            case Op::DrawPoints:
+                img.drawPoints({static_cast<const Point *>(cmd.geometry), cmd.count});
+                break;
+            case Op::DrawLines:
+                img.drawLines({static_cast<const Line *>(cmd.geometry), cmd.count});
+                break;
+            case Op::DrawTriangles:
+                img.drawTriangles({static_cast<const Triangle *>(cmd.geometry), cmd.count});
+                break;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_COMMANDBUFFER_H
+#define CG_COMMANDBUFFER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "render/Image.h"
+
+/**
+ * Recorded sequence of draws and state changes that can be replayed against any Image and camera.
+ * Geometry is referenced, not copied: the recorded spans must outlive the buffer.
+ * Recording validates the geometry once, dropping primitives with non-finite coordinates and triangles with no area,
+ * merges draws of the same kind over contiguous memory into one batch, and skips state changes that change nothing,
+ * so a replay only pays for the batch draws themselves.
+ */
+class CommandBuffer
+{
+public:
+    void setCamera(const Mat4 &mtProj, const Mat4 &mtCam);
+
+    void setShadingMode(Image::ShadingMode mode);
+
+    void setLineSmoothing(bool smooth);
+
+    void drawPoints(std::span<const Point> points);
+
+    void drawLines(std::span<const Line> lines);
+
+    void drawTriangles(std::span<const Triangle> triangles);
+
+    void clear();
+
+    /**
+     * Number of recorded commands, after merging
+     */
+    [[nodiscard]] inline size_t size() const
+    {
+        return commands.size();
+    }
+
+    /**
+     * Run the commands on img, with the camera it currently has
+     * @param img
+     */
+    void replay(Image &img) const;
+
+    /**
+     * Run the commands on img seen from another camera. A camera recorded in the buffer still applies from where it
+     * was recorded.
+     */
+    void replay(Image &img, const Mat4 &mtProj, const Mat4 &mtCam) const;
+
+private:
+    enum class Op : uint8_t
+    {
+        SetCamera, SetShadingMode, SetLineSmoothing, DrawPoints, DrawLines, DrawTriangles
+    };
+
+    struct Command
+    {
+        Op op;
+        uint32_t arg;
+        const void *geometry;
+        size_t count;
+    };
+
+    std::vector<Command> commands;
+    std::vector<std::array<Mat4, 2>> cameras;
+
+    void setState(Op op, uint32_t arg);
+
+    /**
+     * Append the valid runs of items as draws, extending the previous draw when memory is contiguous
+     */
+    template<typename T, typename Valid>
+    void record(Op op, std::span<const T> items, Valid &&valid);
+};
+
+#endif //CG_COMMANDBUFFER_H
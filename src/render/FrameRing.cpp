@@ -0,0 +1,149 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#include "FrameRing.h"
+#include "profile/Profiler.h"
+
+FrameRing::FrameRing(const Image &prototype, size_t count)
+        : freeSlots(static_cast<std::ptrdiff_t>(std::max<size_t>(count, 2)))
+{
+    count = std::max<size_t>(count, 2);
+    slots.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        slots.push_back(std::make_unique<Slot>(prototype));
+        // Room for the longest name of a sequence, so assigning it stays in place
+        slots.back()->filename.reserve(256);
+    }
+    encoder = std::thread(&FrameRing::encodeLoop, this);
+    writer = std::thread(&FrameRing::writeLoop, this);
+}
+
+FrameRing::~FrameRing()
+{
+    finish();
+    stopping.store(true);
+    toEncode.release();
+    toWrite.release();
+    encoder.join();
+    writer.join();
+}
+
+Image &FrameRing::acquire()
+{
+    freeSlots.acquire();
+    return slots[renderIndex]->image;
+}
+
+void FrameRing::submit(const char *filename)
+{
+    auto &slot = *slots[renderIndex];
+    slot.image.resolve();
+    slot.filename = filename;
+    renderIndex = (renderIndex + 1) % slots.size();
+    toEncode.release();
+}
+
+bool FrameRing::finish()
+{
+    // Every target free means every frame submitted is written
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        freeSlots.acquire();
+    }
+    freeSlots.release(static_cast<std::ptrdiff_t>(slots.size()));
+    return failures.exchange(0) == 0;
+}
+
+void FrameRing::encodeLoop()
+{
+    CG_PROFILE_THREAD();
+    while (true)
+    {
+        toEncode.acquire();
+        if (stopping.load())
+        {
+            return;
+        }
+        auto &slot = *slots[encodeIndex];
+        {
+            CG_PROFILE_SCOPE("encode");
+            slot.encoded.bytes.clear();
+            slot.stream.clear();
+            slot.image.flip_vertically();
+            slot.ok = slot.image.write_tga(slot.stream);
+            CG_PROFILE_COUNT(BytesEncoded, slot.encoded.bytes.size());
+        }
+        encodeIndex = (encodeIndex + 1) % slots.size();
+        toWrite.release();
+    }
+}
+
+void FrameRing::writeLoop()
+{
+    CG_PROFILE_THREAD();
+    while (true)
+    {
+        toWrite.acquire();
+        if (stopping.load())
+        {
+            return;
+        }
+        auto &slot = *slots[writeIndex];
+        {
+            CG_PROFILE_SCOPE("write");
+            if (!slot.ok || !writeFile(slot.filename.c_str(), slot.encoded.bytes))
+            {
+                failures.fetch_add(1);
+            }
+        }
+        writeIndex = (writeIndex + 1) % slots.size();
+        freeSlots.release();
+    }
+}
+
+bool FrameRing::writeFile(const char *filename, const std::vector<char> &bytes)
+{
+    int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "can't open file " << filename << "\n";
+        return false;
+    }
+    size_t written = 0;
+    while (written < bytes.size())
+    {
+        auto n = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (n <= 0)
+        {
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    bool ok = ::close(fd) == 0 && written == bytes.size();
+    if (!ok)
+    {
+        std::cerr << "can't write file " << filename << "\n";
+    }
+    return ok;
+}
+
+FrameRing::VectorBuf::int_type FrameRing::VectorBuf::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        bytes.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize FrameRing::VectorBuf::xsputn(const char *s, std::streamsize n)
+{
+    bytes.insert(bytes.end(), s, s + n);
+    return n;
+}
@@ -0,0 +1,121 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_FRAMERING_H
+#define CG_FRAMERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <semaphore>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "render/Image.h"
+
+/**
+ * Fixed set of render targets handed in turn to three stages, for sequences of frames of the same size and mode:
+ * the calling thread renders into one while a thread encodes the previous one as TGA in memory and another writes
+ * the one before to its file. A target goes back to rendering once written, so with count targets the renderer is
+ * at most count - 1 frames ahead of the disk.
+ * Every target, its G-buffer and samples included, its encoded bytes and its file name are made up front and reused,
+ * so past the first frames a sequence of any length doesn't allocate. Stages hand targets over through counting
+ * semaphores, in order, without a lock.
+ */
+class FrameRing
+{
+public:
+    /**
+     * @param prototype copied into every target: size, camera, shading mode, samples and pool
+     * @param count targets, at least 2; 3 lets rendering, encoding and writing all run at once
+     */
+    explicit FrameRing(const Image &prototype, size_t count = 3);
+
+    FrameRing(const FrameRing &) = delete;
+
+    FrameRing &operator=(const FrameRing &) = delete;
+
+    /**
+     * Finish writing the frames submitted
+     */
+    ~FrameRing();
+
+    [[nodiscard]] inline size_t getCount() const
+    {
+        return slots.size();
+    }
+
+    /**
+     * Wait for a free target. Its content is whatever an earlier frame left, so clear it before drawing.
+     * Each acquire must be followed by a submit before the next one.
+     */
+    Image &acquire();
+
+    /**
+     * Resolve the acquired target, then queue it to be written to filename
+     */
+    void submit(const char *filename);
+
+    /**
+     * Wait until every frame submitted is written. Must not be called between acquire and submit.
+     * @return false if a frame couldn't be written since the last call
+     */
+    bool finish();
+
+private:
+    /**
+     * Output buffer appending to a vector whose capacity is kept across frames
+     */
+    class VectorBuf : public std::streambuf
+    {
+    public:
+        std::vector<char> bytes;
+
+    protected:
+        int_type overflow(int_type c) override;
+
+        std::streamsize xsputn(const char *s, std::streamsize n) override;
+    };
+
+    struct Slot
+    {
+        Image image;
+        VectorBuf encoded;
+        std::ostream stream{&encoded};
+        std::string filename;
+        bool ok = false;
+
+        explicit Slot(const Image &prototype) : image(prototype) {}
+    };
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    /**
+     * Next slot of each stage
+     */
+    size_t renderIndex = 0;
+    size_t encodeIndex = 0;
+    size_t writeIndex = 0;
+
+    std::counting_semaphore<> freeSlots;
+    std::counting_semaphore<> toEncode{0};
+    std::counting_semaphore<> toWrite{0};
+    std::atomic<bool> stopping{false};
+    std::atomic<size_t> failures{0};
+
+    std::thread encoder;
+    std::thread writer;
+
+    void encodeLoop();
+
+    void writeLoop();
+
+    /**
+     * Write bytes to filename with the POSIX calls, which don't allocate as a stream does
+     */
+    static bool writeFile(const char *filename, const std::vector<char> &bytes);
+};
+
+#endif //CG_FRAMERING_H
@@ -0,0 +1,105 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_GBUFFER_H
+#define CG_GBUFFER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "tgaimage/tgaimage.h"
+
+/**
+ * Geometry buffer of the deferred shading mode.
+ * The first pass only stores, for the closest fragment of every pixel, its depth, the id of the triangle it
+ * belongs to and two of its barycentric weights. Shading reads these back once per visible pixel.
+ */
+class GBuffer
+{
+public:
+    static constexpr uint32_t emptyId = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Per-triangle data needed by the shading pass
+     */
+    struct TriangleRecord
+    {
+        TGAColor c0, c1, c2;
+    };
+
+    GBuffer() = default;
+
+    GBuffer(int width, int height) { resize(width, height); }
+
+    void resize(int w, int h)
+    {
+        width = w;
+        height = h;
+        depth.resize(static_cast<size_t>(w) * h);
+        ids.resize(static_cast<size_t>(w) * h);
+        bary.resize(static_cast<size_t>(w) * h * 2);
+        clear();
+    }
+
+    /**
+     * Forget every recorded fragment and triangle
+     */
+    void clear()
+    {
+        std::fill(depth.begin(), depth.end(), -std::numeric_limits<float>::infinity());
+        std::fill(ids.begin(), ids.end(), emptyId);
+        triangles.clear();
+    }
+
+    uint32_t addTriangle(const TGAColor &c0, const TGAColor &c1, const TGAColor &c2)
+    {
+        triangles.push_back({c0, c1, c2});
+        return static_cast<uint32_t>(triangles.size() - 1);
+    }
+
+    /**
+     * Depth-tested write; larger depth is closer to the camera.
+     * @return whether the fragment is now the visible one
+     */
+    inline bool write(int x, int y, float z, uint32_t id, float w1, float w2)
+    {
+        size_t i = static_cast<size_t>(y) * width + x;
+        if (z <= depth[i])
+        {
+            return false;
+        }
+        depth[i] = z;
+        ids[i] = id;
+        bary[2 * i] = w1;
+        bary[2 * i + 1] = w2;
+        return true;
+    }
+
+    [[nodiscard]] inline uint32_t idAt(size_t i) const { return ids[i]; }
+
+    [[nodiscard]] inline float depthAt(size_t i) const { return depth[i]; }
+
+    [[nodiscard]] inline float w1At(size_t i) const { return bary[2 * i]; }
+
+    [[nodiscard]] inline float w2At(size_t i) const { return bary[2 * i + 1]; }
+
+    [[nodiscard]] inline const TriangleRecord &triangle(uint32_t id) const { return triangles[id]; }
+
+    [[nodiscard]] inline bool empty() const { return triangles.empty(); }
+
+    [[nodiscard]] inline int getWidth() const { return width; }
+
+    [[nodiscard]] inline int getHeight() const { return height; }
+
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<float> depth;
+    std::vector<uint32_t> ids;
+    std::vector<float> bary;
+    std::vector<TriangleRecord> triangles;
+};
+
+#endif //CG_GBUFFER_H
@@ -0,0 +1,909 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include "Image.h"
+#include "profile/Profiler.h"
+
+using namespace std;
+
+static inline TGAColor makeColor(const Vec4 &v)
+{
+    return {static_cast<unsigned char>(v[0]), static_cast<unsigned char>(v[1]), static_cast<unsigned char>(v[2]),
+            static_cast<unsigned char>(v[3])};
+}
+
+static inline Vec4 convertColorToVec4(const TGAColor &c)
+{
+    return {static_cast<Real>(c.r), static_cast<Real>(c.g), static_cast<Real>(c.b), static_cast<Real>(c.a)};
+}
+
+/**
+ * v on the 1/16 pixel grid triangle vertices snap to. Rounding it next to a pixel edge, such as the centre of an image
+ * of even size, then goes the same way whatever error float precision left in v.
+ */
+static inline double toSubpixel(double v)
+{
+    return std::round(v * Fixed28p4::one) / Fixed28p4::one;
+}
+
+/**
+ * Liang–Barsky step: shrink [t0, t1] to the part of p + t * d lying in [lo, hi]
+ * @return false when nothing is left
+ */
+static inline bool clipAxis(double p, double d, double lo, double hi, double &t0, double &t1)
+{
+    if (d == 0)
+    {
+        return p >= lo && p <= hi;
+    }
+    double ta = (lo - p) / d, tb = (hi - p) / d;
+    if (ta > tb)
+    {
+        swap(ta, tb);
+    }
+    t0 = max(t0, ta);
+    t1 = min(t1, tb);
+    return t0 <= t1;
+}
+
+/**
+ * Steps a color from c0 to c1 in 16.16 fixed point, one channel per byte of TGAColor::raw
+ */
+class ColorStep
+{
+private:
+    std::array<int64_t, 4> value{};
+    std::array<int64_t, 4> delta{};
+public:
+    ColorStep(const TGAColor &c0, const TGAColor &c1, long long steps, long long start)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            delta[i] = steps ? (static_cast<int64_t>(c1.raw[i] - c0.raw[i]) << 16) / steps : 0;
+            value[i] = (static_cast<int64_t>(c0.raw[i]) << 16) + delta[i] * start;
+        }
+    }
+
+    inline void next()
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            value[i] += delta[i];
+        }
+    }
+
+    [[nodiscard]] inline TGAColor get() const
+    {
+        return {static_cast<unsigned char>(value[2] >> 16), static_cast<unsigned char>(value[1] >> 16),
+                static_cast<unsigned char>(value[0] >> 16), static_cast<unsigned char>(value[3] >> 16)};
+    }
+};
+
+namespace
+{
+    /**
+     * Gathers the fragments of a row into runs of consecutive pixels, and blends each run with one span operation.
+     * Triangles being convex, a triangle gives one run per row. Runs are blended in the order they were gathered.
+     */
+    class SpanBlender
+    {
+    public:
+        SpanBlender(unsigned char *data, int width, int bytespp, BlendMode mode)
+                : data(data), width(width), bytespp(bytespp), mode(mode) {}
+
+        SpanBlender(const SpanBlender &) = delete;
+
+        SpanBlender &operator=(const SpanBlender &) = delete;
+
+        ~SpanBlender()
+        {
+            flush();
+        }
+
+        inline void add(int x, int y, const TGAColor &c)
+        {
+            if (count && (y != spanY || x != spanX + static_cast<int>(count) || count == colors.size()))
+            {
+                flush();
+            }
+            if (!count)
+            {
+                spanX = x;
+                spanY = y;
+            }
+            colors[count++] = c;
+        }
+
+        void flush()
+        {
+            if (count)
+            {
+                blendSpan(mode, data + (static_cast<size_t>(spanY) * width + spanX) * bytespp, colors.data(), count,
+                          bytespp);
+                count = 0;
+            }
+        }
+
+    private:
+        unsigned char *data;
+        int width;
+        int bytespp;
+        BlendMode mode;
+        int spanX = 0;
+        int spanY = 0;
+        size_t count = 0;
+        std::array<TGAColor, 64> colors;
+    };
+}
+
+void Image::setShadingMode(Image::ShadingMode mode)
+{
+    if (mode == shadingMode)
+    {
+        return;
+    }
+    resolve();
+    shadingMode = mode;
+    if (mode == ShadingMode::Deferred)
+    {
+        gBuffer.resize(width, height);
+    } else
+    {
+        gBuffer = GBuffer();
+    }
+}
+
+void Image::setMultisample(int count, SampleBuffer::Filter filter)
+{
+    assert(count == 1 || count == 4 || count == 8);
+    resolveFilter = filter;
+    if (count == getSampleCount())
+    {
+        return;
+    }
+    resolve();
+    if (count == 1)
+    {
+        samples = SampleBuffer();
+        return;
+    }
+    samples = SampleBuffer(width, height, bytespp, count);
+    samples.fill(data);
+}
+
+void Image::setBlendMode(BlendMode mode)
+{
+    blendMode = mode;
+}
+
+void Image::setOrderIndependent(bool enable)
+{
+    if (enable == orderIndependent)
+    {
+        return;
+    }
+    resolve();
+    orderIndependent = enable;
+    if (enable)
+    {
+        transparency.resize(width, height);
+    } else
+    {
+        transparency = TransparencyBuffer();
+    }
+}
+
+void Image::clear()
+{
+    clear(TGAColor(0, 0, 0, 0));
+}
+
+void Image::clear(const TGAColor &c)
+{
+    TGAImage::clear(c);
+    if (!samples.empty())
+    {
+        samples.fill(data);
+    }
+    // An empty G-buffer has had no fragment written since its last clear
+    if (!gBuffer.empty())
+    {
+        gBuffer.clear();
+    }
+    if (transparencyPending)
+    {
+        transparency.clear();
+        transparencyPending = false;
+    }
+}
+
+void Image::setLineSmoothing(bool smooth)
+{
+    smoothLines = smooth;
+}
+
+void Image::draw(const Line &line)
+{
+    if (smoothLines)
+    {
+        auto p1 = project(line.p1), p2 = project(line.p2);
+        drawSmoothLine(p1.getX(), p1.getY(), line.p1.color, p2.getX(), p2.getY(), line.p2.color);
+        return;
+    }
+    auto p1 = transform(line.p1), p2 = transform(line.p2);
+    draw(p1.getX(), p1.getY(), line.p1.color, p2.getX(), p2.getY(), line.p2.color);
+}
+
+void Image::draw(int x0, int y0, TGAColor c0, int x1, int y1, TGAColor c1)
+{
+    if (smoothLines)
+    {
+        drawSmoothLine(x0, y0, c0, x1, y1, c1);
+        return;
+    }
+    // Walk the major axis m one pixel at a time, the minor axis n follows the midpoint decision
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    int m0 = steep ? y0 : x0, n0 = steep ? x0 : y0, m1 = steep ? y1 : x1, n1 = steep ? x1 : y1;
+    if (m0 > m1)
+    {
+        swap(m0, m1);
+        swap(n0, n1);
+        swap(c0, c1);
+    }
+    int mSize = steep ? height : width, nSize = steep ? width : height;
+    long long dm = m1 - m0, dn = abs(n1 - n0);
+    int sn = n1 < n0 ? -1 : 1;
+
+    double t0 = 0, t1 = 1;
+    if (!clipAxis(m0, static_cast<double>(dm), -0.5, mSize - 0.5, t0, t1) ||
+        !clipAxis(n0, static_cast<double>(n1 - n0), -0.5, nSize - 0.5, t0, t1))
+    {
+        return;
+    }
+    // The minor axis rounds to within half a pixel of the line: widen by one and check it per pixel
+    long long mBegin = max({static_cast<long long>(m0), static_cast<long long>(floor(m0 + t0 * dm)), 0LL});
+    long long mEnd = min({static_cast<long long>(m1), static_cast<long long>(ceil(m0 + t1 * dm)),
+                          static_cast<long long>(mSize - 1)});
+
+    // Minor offset and decision variable at mBegin, as if the walk had started at m0
+    long long k = dm == 0 ? 0 : (2 * dn * (mBegin - m0) - dm + 2 * dm - 1) / (2 * dm);
+    long long d = -2 * dn * (mBegin + 1 - m0) + dm * (2 * k + 1);
+    ColorStep color(c0, c1, dm, mBegin - m0);
+
+    auto mStride = static_cast<ptrdiff_t>(steep ? width * bytespp : bytespp);
+    auto nStride = static_cast<ptrdiff_t>(steep ? bytespp : width * bytespp) * sn;
+    long long n = n0 + sn * k;
+    ptrdiff_t at = (steep ? n + mBegin * width : mBegin + n * width) * bytespp;
+    for (long long m = mBegin; m <= mEnd; ++m)
+    {
+        if (n >= 0 && n < nSize)
+        {
+            auto c = color.get();
+            if (samples.empty())
+            {
+                memcpy(data + at, c.raw, bytespp);
+            } else
+            {
+                samples.writeAll(static_cast<int>(steep ? n : m), static_cast<int>(steep ? m : n), c);
+            }
+        }
+        if (d < 0)
+        {
+            n += sn;
+            at += nStride;
+            d += 2 * dm - 2 * dn;
+        } else
+        {
+            d -= 2 * dn;
+        }
+        at += mStride;
+        color.next();
+    }
+}
+
+void Image::drawSmoothLine(double x0, double y0, TGAColor c0, double x1, double y1, TGAColor c1)
+{
+    x0 = toSubpixel(x0);
+    y0 = toSubpixel(y0);
+    x1 = toSubpixel(x1);
+    y1 = toSubpixel(y1);
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep)
+    {
+        swap(x0, y0);
+        swap(x1, y1);
+    }
+    if (x0 > x1)
+    {
+        swap(x0, x1);
+        swap(y0, y1);
+        swap(c0, c1);
+    }
+    int mSize = steep ? height : width, nSize = steep ? width : height;
+    double dm = x1 - x0, dn = y1 - y0;
+    // Two pixels are touched per column, so keep a one pixel margin
+    double t0 = 0, t1 = 1;
+    if (!clipAxis(x0, dm, -1, mSize, t0, t1) || !clipAxis(y0, dn, -1, nSize, t0, t1))
+    {
+        return;
+    }
+    double gradient = dm == 0 ? 0 : dn / dm;
+    long mFirst = lround(x0), mLast = lround(x1);
+    long mBegin = max({mFirst, lround(x0 + t0 * dm), 0L}), mEnd = min({mLast, lround(x0 + t1 * dm), mSize - 1L});
+    ColorStep color(c0, c1, mLast - mFirst, mBegin - mFirst);
+    double n = y0 + gradient * (static_cast<double>(mBegin) - x0);
+    for (long m = mBegin; m <= mEnd; ++m)
+    {
+        // Endpoints only cover the part of their column the segment actually spans
+        double span = 1;
+        if (m == mFirst)
+        {
+            span = 1 - (x0 + 0.5 - floor(x0 + 0.5));
+        }
+        if (m == mLast)
+        {
+            span = min(span, x1 + 0.5 - floor(x1 + 0.5));
+        }
+        auto nFloor = static_cast<long>(floor(n));
+        double f = n - static_cast<double>(nFloor);
+        auto c = color.get();
+        for (int i = 0; i < 2; ++i)
+        {
+            long ni = nFloor + i;
+            auto coverage = static_cast<int>(256 * span * (i ? f : 1 - f));
+            if (ni >= 0 && ni < nSize && coverage > 0)
+            {
+                blendPixel(static_cast<int>(steep ? ni : m), static_cast<int>(steep ? m : ni), c, coverage);
+            }
+        }
+        n += gradient;
+        color.next();
+    }
+}
+
+void Image::blendPixel(int x, int y, const TGAColor &c, int coverage)
+{
+    if (!samples.empty())
+    {
+        samples.blend(x, y, c, coverage);
+        return;
+    }
+    unsigned char *p = data + (static_cast<size_t>(y) * width + x) * bytespp;
+    for (int i = 0; i < bytespp; ++i)
+    {
+        p[i] = static_cast<unsigned char>(p[i] + (((c.raw[i] - p[i]) * coverage) >> 8));
+    }
+}
+
+template<typename Emit>
+void Image::setupClipped(const std::array<ClipVertex, 3> &triangle, Emit &&emit)
+{
+    std::array<ClipVertex, 7> polygon;
+    size_t count = clipToGuardBand(triangle, polygon);
+    const ClipVertex &a = polygon[0];
+    for (size_t k = 1; k + 1 < count; ++k)
+    {
+        const ClipVertex &b = polygon[k], &c = polygon[k + 1];
+        TriangleSetup setup;
+        if (setup.setup(snapFixed(a.x, a.y), a.getColor(), snapFixed(b.x, b.y), b.getColor(), snapFixed(c.x, c.y),
+                        c.getColor()))
+        {
+            emit(setup, static_cast<Real>(a.z), static_cast<Real>(b.z), static_cast<Real>(c.z));
+        }
+    }
+}
+
+void Image::draw(const Triangle &triangle)
+{
+    CG_PROFILE_COUNT(TrianglesIn, 1);
+    auto v0 = project(triangle.p1), v1 = project(triangle.p2), v2 = project(triangle.p3);
+    if (!insideGuardBand(v0.getX(), v0.getY()) || !insideGuardBand(v1.getX(), v1.getY()) ||
+        !insideGuardBand(v2.getX(), v2.getY()))
+    {
+        setupClipped({ClipVertex(v0.getX(), v0.getY(), v0.getZ(), triangle.p1.color),
+                      ClipVertex(v1.getX(), v1.getY(), v1.getZ(), triangle.p2.color),
+                      ClipVertex(v2.getX(), v2.getY(), v2.getZ(), triangle.p3.color)},
+                     [this](const TriangleSetup &setup, Real z0, Real z1, Real z2)
+                     {
+                         rasterize(setup, z0, z1, z2);
+                     });
+        return;
+    }
+    TriangleSetup setup;
+    if (!setup.setup(snapFixed(v0), triangle.p1.color, snapFixed(v1), triangle.p2.color, snapFixed(v2),
+                     triangle.p3.color))
+    {
+        CG_PROFILE_COUNT(TrianglesCulled, 1);
+        return;
+    }
+    rasterize(setup, v0.getZ(), v1.getZ(), v2.getZ());
+}
+
+void Image::draw(int x0, int y0, const TGAColor &c0, int x1, int y1, const TGAColor &c1, int x2, int y2,
+                 const TGAColor &c2)
+{
+    auto draw = [this](const TriangleSetup &setup, Real z0, Real z1, Real z2)
+    {
+        rasterize(setup, z0, z1, z2);
+    };
+    if (!insideGuardBand(x0, y0) || !insideGuardBand(x1, y1) || !insideGuardBand(x2, y2))
+    {
+        setupClipped({ClipVertex(x0, y0, 0, c0), ClipVertex(x1, y1, 0, c1), ClipVertex(x2, y2, 0, c2)}, draw);
+        return;
+    }
+    TriangleSetup setup;
+    if (setup.setup(FVec2{Fixed28p4(x0), Fixed28p4(y0)}, c0, FVec2{Fixed28p4(x1), Fixed28p4(y1)}, c1,
+                    FVec2{Fixed28p4(x2), Fixed28p4(y2)}, c2))
+    {
+        draw(setup, 0, 0, 0);
+    }
+}
+
+void Image::rasterize(const TriangleSetup &setup, Real z0, Real z1, Real z2)
+{
+    if (accumulates(setup))
+    {
+        rasterizeTransparent(setup, z0, z1, z2);
+    } else if (shadingMode == ShadingMode::Deferred)
+    {
+        rasterizeDeferred(setup, z0, z1, z2, gBuffer.addTriangle(setup.c0, setup.c1, setup.c2));
+    } else if (!samples.empty())
+    {
+        rasterizeMultisample(setup);
+    } else if (blendMode != BlendMode::Replace)
+    {
+        CG_PROFILE_ONLY(uint64_t fragments = 0);
+        SpanBlender spans(data, width, bytespp, blendMode);
+        setup.rasterize(0, 0, width - 1, height - 1, [&](int x, int y, Real w0, Real w1, Real w2)
+        {
+            CG_PROFILE_ONLY(++fragments);
+            spans.add(x, y, setup.shade(w0, w1, w2));
+        });
+        CG_PROFILE_COUNT(FragmentsTested, fragments);
+        CG_PROFILE_COUNT(FragmentsPassed, fragments);
+        CG_PROFILE_COUNT(PixelsWritten, fragments);
+    } else
+    {
+        CG_PROFILE_ONLY(uint64_t fragments = 0);
+        setup.rasterize(0, 0, width - 1, height - 1, [&](int x, int y, Real w0, Real w1, Real w2)
+        {
+            CG_PROFILE_ONLY(++fragments);
+            memcpy(data + (static_cast<size_t>(y) * width + x) * bytespp, setup.shade(w0, w1, w2).raw, bytespp);
+        });
+        CG_PROFILE_COUNT(FragmentsTested, fragments);
+        CG_PROFILE_COUNT(FragmentsPassed, fragments);
+        CG_PROFILE_COUNT(PixelsWritten, fragments);
+    }
+}
+
+void Image::rasterizeDeferred(const TriangleSetup &setup, Real z0, Real z1, Real z2, uint32_t id)
+{
+    CG_PROFILE_ONLY(uint64_t tested = 0);
+    CG_PROFILE_ONLY(uint64_t passed = 0);
+    setup.rasterize(0, 0, width - 1, height - 1, [&](int x, int y, Real w0, Real w1, Real w2)
+    {
+        auto z = static_cast<float>(w0 * z0 + w1 * z1 + w2 * z2);
+        CG_PROFILE_ONLY(++tested);
+        if (gBuffer.write(x, y, z, id, static_cast<float>(w1), static_cast<float>(w2)))
+        {
+            CG_PROFILE_ONLY(++passed);
+        }
+    });
+    CG_PROFILE_COUNT(FragmentsTested, tested);
+    CG_PROFILE_COUNT(FragmentsPassed, passed);
+}
+
+void Image::rasterizeMultisample(const TriangleSetup &setup)
+{
+    setup.rasterizeSamples(0, 0, width - 1, height - 1, samples.offsets(), samples.count(),
+                           [this, &setup](int x, int y, unsigned mask, Real w0, Real w1, Real w2)
+                           {
+                               // The centre may lie outside on edge pixels: clamp so the color stays in range
+                               w0 = max(w0, Real(0)), w1 = max(w1, Real(0)), w2 = max(w2, Real(0));
+                               Real sum = w0 + w1 + w2;
+                               auto c = setup.shade(w0 / sum, w1 / sum, w2 / sum);
+                               if (blendMode == BlendMode::Replace)
+                               {
+                                   samples.write(x, y, mask, c);
+                               } else
+                               {
+                                   samples.write(x, y, mask, c, blendMode);
+                               }
+                           });
+}
+
+void Image::rasterizeTransparent(const TriangleSetup &setup, Real z0, Real z1, Real z2)
+{
+    transparencyPending = true;
+    auto depth = [&](Real w0, Real w1, Real w2)
+    {
+        return static_cast<float>(w0 * z0 + w1 * z1 + w2 * z2);
+    };
+    if (samples.empty())
+    {
+        setup.rasterize(0, 0, width - 1, height - 1, [&](int x, int y, Real w0, Real w1, Real w2)
+        {
+            transparency.add(static_cast<size_t>(y) * width + x, setup.shade(w0, w1, w2), depth(w0, w1, w2));
+        });
+        return;
+    }
+    // Layers are kept per pixel: samples only scale the weight by the part of the pixel covered
+    auto perSample = 1.f / static_cast<float>(samples.count());
+    setup.rasterizeSamples(0, 0, width - 1, height - 1, samples.offsets(), samples.count(),
+                           [&](int x, int y, unsigned mask, Real w0, Real w1, Real w2)
+                           {
+                               w0 = max(w0, Real(0)), w1 = max(w1, Real(0)), w2 = max(w2, Real(0));
+                               Real sum = w0 + w1 + w2;
+                               w0 /= sum, w1 /= sum, w2 /= sum;
+                               transparency.add(static_cast<size_t>(y) * width + x, setup.shade(w0, w1, w2),
+                                                depth(w0, w1, w2),
+                                                static_cast<float>(popcount(mask)) * perSample);
+                           });
+}
+
+void Image::resolveTransparency()
+{
+    if (!transparencyPending)
+    {
+        return;
+    }
+    CG_PROFILE_SCOPE("transparency composite");
+    jobs->parallelFor(0, height, [this](size_t yBegin, size_t yEnd)
+    {
+        transparency.composite(static_cast<int>(yBegin), static_cast<int>(yEnd), data, bytespp);
+    });
+    transparencyPending = false;
+}
+
+void Image::resolve()
+{
+    resolveDeferred();
+    if (!samples.empty())
+    {
+        CG_PROFILE_SCOPE("msaa resolve");
+        samples.resolve(data, resolveFilter, *jobs, frameArena.local());
+        CG_PROFILE_COUNT(PixelsWritten, static_cast<uint64_t>(width) * height);
+    }
+    resolveTransparency();
+    frameArena.reset();
+}
+
+bool Image::save(const char *filename)
+{
+    resolve();
+    CG_PROFILE_SCOPE("encode");
+    flip_vertically();
+    if (!write_tga_file(filename))
+    {
+        return false;
+    }
+    CG_PROFILE_COUNT(BytesEncoded, filesystem::file_size(filename));
+    return true;
+}
+
+void Image::resolveDeferred()
+{
+    if (shadingMode != ShadingMode::Deferred || gBuffer.empty())
+    {
+        return;
+    }
+    CG_PROFILE_SCOPE("deferred shade");
+    jobs->parallelFor(0, height, [this](size_t yBegin, size_t yEnd)
+    {
+        CG_PROFILE_SCOPE("deferred shade rows");
+        CG_PROFILE_ONLY(uint64_t written = 0);
+        for (int y = static_cast<int>(yBegin); y < static_cast<int>(yEnd); ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                size_t i = static_cast<size_t>(y) * width + x;
+                auto id = gBuffer.idAt(i);
+                if (id == GBuffer::emptyId)
+                {
+                    continue;
+                }
+                CG_PROFILE_ONLY(++written);
+                const auto &tri = gBuffer.triangle(id);
+                Real w1 = gBuffer.w1At(i), w2 = gBuffer.w2At(i), w0 = 1 - w1 - w2;
+                auto color = w0 * convertColorToVec4(tri.c0) + w1 * convertColorToVec4(tri.c1) +
+                             w2 * convertColorToVec4(tri.c2);
+                plot(x, y, makeColor(color));
+            }
+        }
+        CG_PROFILE_COUNT(PixelsWritten, written);
+    });
+    gBuffer.clear();
+}
+
+namespace
+{
+    /**
+     * Vertex after the bulk transform of the batch API
+     */
+    struct ScreenVertex
+    {
+        Real x, y, z;
+        bool visible;
+    };
+
+    using FlatMat4 = std::array<Real, 16>;
+
+    FlatMat4 flatten(const Mat4 &m)
+    {
+        FlatMat4 ret{};
+        for (size_t i = 0; i < 4; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+            {
+                ret[i * 4 + j] = m[i][j];
+            }
+        }
+        return ret;
+    }
+
+    inline ScreenVertex toScreen(const Point &p, const FlatMat4 &m, Real wSign)
+    {
+        Real px = p[0], py = p[1], pz = p[2];
+        Real w = m[12] * px + m[13] * py + m[14] * pz + m[15];
+        Real inv = 1 / w;
+        return {(m[0] * px + m[1] * py + m[2] * pz + m[3]) * inv,
+                (m[4] * px + m[5] * py + m[6] * pz + m[7]) * inv,
+                (m[8] * px + m[9] * py + m[10] * pz + m[11]) * inv,
+                w * wSign > 0};
+    }
+
+    inline int snap(double v)
+    {
+        constexpr double limit = std::numeric_limits<int>::max();
+        return static_cast<int>(lround(toSubpixel(std::clamp(v, -limit, limit))));
+    }
+}
+
+FVec2 Image::snapFixed(double x, double y)
+{
+    return FVec2{Fixed28p4::fromDouble(x), Fixed28p4::fromDouble(y)};
+}
+
+void Image::drawPoints(std::span<const Point> points)
+{
+    auto m = flatten(mtRes);
+    for (auto &point: points)
+    {
+        auto v = toScreen(point, m, wSign);
+        if (v.visible)
+        {
+            plot(snap(v.x), snap(v.y), point.color);
+        }
+    }
+}
+
+void Image::drawLines(std::span<const Line> lines)
+{
+    auto m = flatten(mtRes);
+    for (auto &line: lines)
+    {
+        auto v1 = toScreen(line.p1, m, wSign), v2 = toScreen(line.p2, m, wSign);
+        if (!v1.visible || !v2.visible)
+        {
+            continue;
+        }
+        if (smoothLines)
+        {
+            drawSmoothLine(v1.x, v1.y, line.p1.color, v2.x, v2.y, line.p2.color);
+        } else
+        {
+            draw(snap(v1.x), snap(v1.y), line.p1.color, snap(v2.x), snap(v2.y), line.p2.color);
+        }
+    }
+}
+
+void Image::drawTriangles(std::span<const Triangle> triangles)
+{
+    CG_PROFILE_SCOPE("draw triangles");
+    CG_PROFILE_COUNT(TrianglesIn, triangles.size());
+    auto m = flatten(mtRes);
+    // Transform and setup are independent per triangle; only what follows depends on the order
+    auto &arena = frameArena.local();
+    auto setups = arena.allocate<TriangleSetup>(triangles.size());
+    auto depths = arena.allocate<array<Real, 3>>(triangles.size());
+    // 0 culled, 1 set up, clip to set up after clipping to the guard band
+    constexpr uint8_t clip = 2;
+    auto kept = arena.allocate<uint8_t>(triangles.size());
+    fill(kept.begin(), kept.end(), 0);
+    jobs->parallelFor(0, triangles.size(), batchGrain, [&](size_t begin, size_t end)
+    {
+        CG_PROFILE_SCOPE("transform and setup");
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto &triangle = triangles[i];
+            auto v0 = toScreen(triangle.p1, m, wSign), v1 = toScreen(triangle.p2, m, wSign),
+                    v2 = toScreen(triangle.p3, m, wSign);
+            if (!v0.visible || !v1.visible || !v2.visible)
+            {
+                continue;
+            }
+            if (!insideGuardBand(v0.x, v0.y) || !insideGuardBand(v1.x, v1.y) || !insideGuardBand(v2.x, v2.y))
+            {
+                // Rare: clipped in order, after this pass
+                kept[i] = clip;
+                continue;
+            }
+            auto &setup = setups[i];
+            kept[i] = setup.setup(snapFixed(v0.x, v0.y), triangle.p1.color, snapFixed(v1.x, v1.y),
+                                  triangle.p2.color, snapFixed(v2.x, v2.y), triangle.p3.color) &&
+                      setup.xMax >= -1 && setup.yMax >= -1 && setup.xMin <= width && setup.yMin <= height;
+            depths[i] = {v0.z, v1.z, v2.z};
+        }
+    });
+    auto forClipped = [&](size_t i, auto &&emit)
+    {
+        auto &triangle = triangles[i];
+        auto v0 = toScreen(triangle.p1, m, wSign), v1 = toScreen(triangle.p2, m, wSign),
+                v2 = toScreen(triangle.p3, m, wSign);
+        setupClipped({ClipVertex(v0.x, v0.y, v0.z, triangle.p1.color),
+                      ClipVertex(v1.x, v1.y, v1.z, triangle.p2.color),
+                      ClipVertex(v2.x, v2.y, v2.z, triangle.p3.color)}, emit);
+    };
+    if (shadingMode == ShadingMode::Forward && samples.empty())
+    {
+        // Compacted in place, unless clipping adds triangles: a clipped polygon has up to 5
+        size_t clipped = static_cast<size_t>(std::count(kept.begin(), kept.end(), clip));
+        auto outSetups = clipped ? arena.allocate<TriangleSetup>(setups.size() + 4 * clipped) : setups;
+        auto outDepths = clipped ? arena.allocate<array<Real, 3>>(setups.size() + 4 * clipped) : depths;
+        size_t count = 0;
+        auto append = [&](const TriangleSetup &setup, Real z0, Real z1, Real z2)
+        {
+            transparencyPending = transparencyPending || accumulates(setup);
+            outDepths[count] = {z0, z1, z2};
+            outSetups[count++] = setup;
+        };
+        for (size_t i = 0; i < setups.size(); ++i)
+        {
+            if (kept[i] == clip)
+            {
+                forClipped(i, append);
+            } else if (kept[i])
+            {
+                append(setups[i], depths[i][0], depths[i][1], depths[i][2]);
+            } else
+            {
+                CG_PROFILE_COUNT(TrianglesCulled, 1);
+            }
+        }
+        rasterizeTiles(outSetups.first(count), outDepths.first(count));
+    } else
+    {
+        CG_PROFILE_SCOPE("rasterize in order");
+        auto draw = [this](const TriangleSetup &setup, Real z0, Real z1, Real z2)
+        {
+            rasterize(setup, z0, z1, z2);
+        };
+        for (size_t i = 0; i < setups.size(); ++i)
+        {
+            if (kept[i] == clip)
+            {
+                forClipped(i, draw);
+            } else if (kept[i])
+            {
+                draw(setups[i], depths[i][0], depths[i][1], depths[i][2]);
+            } else
+            {
+                CG_PROFILE_COUNT(TrianglesCulled, 1);
+            }
+        }
+    }
+    frameArena.reset();
+}
+
+void Image::rasterizeTiles(std::span<const TriangleSetup> setups, std::span<const array<Real, 3>> depths)
+{
+    if (setups.empty())
+    {
+        return;
+    }
+    int tilesX = (width + tileSize - 1) / tileSize, tilesY = (height + tileSize - 1) / tileSize;
+    size_t tiles = static_cast<size_t>(tilesX) * tilesY;
+    // Each chunk of triangles is binned on its own; walking the chunks in order keeps the bins in submission order,
+    // so overlapping triangles still end up as if drawn in sequence.
+    // The bins of a chunk are one array of triangle indices sorted by tile, with the start of each tile's run
+    // in offsets, counted in a first pass over the chunk so both come from the arena of the thread binning it.
+    size_t chunks = (setups.size() + batchGrain - 1) / batchGrain;
+    auto &arena = frameArena.local();
+    auto offsets = arena.allocate<uint32_t *>(chunks), bins = arena.allocate<uint32_t *>(chunks);
+    jobs->parallelFor(0, chunks, 1, [&](size_t chunkBegin, size_t chunkEnd)
+    {
+        CG_PROFILE_SCOPE("bin");
+        auto &chunkArena = frameArena.local();
+        for (size_t c = chunkBegin; c < chunkEnd; ++c)
+        {
+            auto begin = static_cast<uint32_t>(c * batchGrain);
+            auto end = static_cast<uint32_t>(min(setups.size(), (c + 1) * batchGrain));
+            auto forTiles = [&](const TriangleSetup &s, auto &&f)
+            {
+                int tx0 = max(s.xMin, 0) / tileSize, tx1 = min(s.xMax, width - 1) / tileSize;
+                int ty0 = max(s.yMin, 0) / tileSize, ty1 = min(s.yMax, height - 1) / tileSize;
+                for (int ty = ty0; ty <= ty1; ++ty)
+                {
+                    for (int tx = tx0; tx <= tx1; ++tx)
+                    {
+                        f(static_cast<size_t>(ty) * tilesX + tx);
+                    }
+                }
+            };
+            auto starts = chunkArena.allocate<uint32_t>(tiles + 1);
+            fill(starts.begin(), starts.end(), 0);
+            for (auto i = begin; i < end; ++i)
+            {
+                forTiles(setups[i], [&](size_t t) { ++starts[t + 1]; });
+            }
+            for (size_t t = 0; t < tiles; ++t)
+            {
+                starts[t + 1] += starts[t];
+            }
+            auto items = chunkArena.allocate<uint32_t>(starts[tiles]);
+            auto cursors = chunkArena.allocate<uint32_t>(tiles);
+            copy(starts.begin(), starts.end() - 1, cursors.begin());
+            for (auto i = begin; i < end; ++i)
+            {
+                forTiles(setups[i], [&](size_t t) { items[cursors[t]++] = i; });
+            }
+            offsets[c] = starts.data();
+            bins[c] = items.data();
+        }
+    });
+    jobs->parallelFor(0, tiles, 1, [&](size_t tileBegin, size_t tileEnd)
+    {
+        CG_PROFILE_SCOPE("raster tile");
+        CG_PROFILE_ONLY(uint64_t fragments = 0);
+        for (size_t t = tileBegin; t < tileEnd; ++t)
+        {
+            int x0 = static_cast<int>(t % tilesX) * tileSize, y0 = static_cast<int>(t / tilesX) * tileSize;
+            int x1 = min(x0 + tileSize, width) - 1, y1 = min(y0 + tileSize, height) - 1;
+            SpanBlender spans(data, width, bytespp, blendMode);
+            for (size_t c = 0; c < chunks; ++c)
+            {
+                for (auto k = offsets[c][t]; k < offsets[c][t + 1]; ++k)
+                {
+                    auto &s = setups[bins[c][k]];
+                    if (accumulates(s))
+                    {
+                        // Tiles own their pixels, so the sums of a pixel are only touched by one job
+                        auto &z = depths[bins[c][k]];
+                        s.rasterize(x0, y0, x1, y1, [&](int x, int y, Real w0, Real w1, Real w2)
+                        {
+                            transparency.add(static_cast<size_t>(y) * width + x, s.shade(w0, w1, w2),
+                                             static_cast<float>(w0 * z[0] + w1 * z[1] + w2 * z[2]));
+                        });
+                    } else if (blendMode != BlendMode::Replace)
+                    {
+                        s.rasterize(x0, y0, x1, y1, [&](int x, int y, Real w0, Real w1, Real w2)
+                        {
+                            CG_PROFILE_ONLY(++fragments);
+                            spans.add(x, y, s.shade(w0, w1, w2));
+                        });
+                    } else
+                    {
+                        s.rasterize(x0, y0, x1, y1, [&](int x, int y, Real w0, Real w1, Real w2)
+                        {
+                            CG_PROFILE_ONLY(++fragments);
+                            memcpy(data + (static_cast<size_t>(y) * width + x) * bytespp, s.shade(w0, w1, w2).raw,
+                                   bytespp);
+                        });
+                    }
+                }
+            }
+        }
+        CG_PROFILE_COUNT(FragmentsTested, fragments);
+        CG_PROFILE_COUNT(FragmentsPassed, fragments);
+        CG_PROFILE_COUNT(PixelsWritten, fragments);
+    });
+}
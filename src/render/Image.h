@@ -0,0 +1,386 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_IMAGE_H
+#define CG_IMAGE_H
+
+#include <array>
+#include <span>
+#include <utility>
+#include <vector>
+#include "linear/Vec.h"
+#include "linear/Mat.h"
+#include "linear/Bounds.h"
+#include "tgaimage/tgaimage.h"
+#include "job/JobSystem.h"
+#include "memory/FrameArena.h"
+#include "render/Blend.h"
+#include "render/GBuffer.h"
+#include "render/Raster.h"
+#include "render/SampleBuffer.h"
+#include "render/TransparencyBuffer.h"
+
+
+struct Point : public Vec3
+{
+    TGAColor color{};
+
+    Point() = default;
+
+    Point(const Vec3 &v, const TGAColor &color) : Vec3(v), color(color) {}
+
+    [[nodiscard]] inline Vec3 toVec3() const
+    {
+        return Vec3(arr[0], arr[1], arr[2]);
+    }
+
+};
+
+struct Line
+{
+    Point p1;
+    Point p2;
+
+    Line() = default;
+
+    Line(Point p1, Point p2) : p1(std::move(p1)), p2(std::move(p2)) {}
+};
+
+struct Triangle
+{
+    Point p1;
+    Point p2;
+    Point p3;
+
+    Triangle() = default;
+
+    Triangle(Point p1, Point p2, Point p3) : p1(std::move(p1)), p2(std::move(p2)), p3(std::move(p3)) {}
+};
+
+
+class Image : public TGAImage
+{
+public:
+    /**
+     * Forward shades every covered fragment as it is rasterized.
+     * Deferred only records the closest fragment of each pixel in a G-buffer and shades it once in resolve().
+     */
+    enum class ShadingMode
+    {
+        Forward, Deferred
+    };
+
+private:
+
+    static constexpr int tileSize = 64;
+
+    /**
+     * Triangles per job of the batch transform and binning
+     */
+    static constexpr size_t batchGrain = 1024;
+
+    Mat4 mtRes;
+
+    /**
+     * Projection times camera, without the viewport
+     */
+    Mat4 mtClip;
+
+    Frustum frustum;
+
+    /**
+     * Sign of w for points in front of the camera: negative for the perspective projection, which keeps w = z
+     */
+    Real wSign;
+
+    ShadingMode shadingMode = ShadingMode::Forward;
+
+    GBuffer gBuffer;
+
+    SampleBuffer samples;
+
+    SampleBuffer::Filter resolveFilter = SampleBuffer::Filter::Box;
+
+    bool smoothLines = false;
+
+    BlendMode blendMode = BlendMode::Replace;
+
+    /**
+     * Translucent triangles go to the transparency buffer instead of being blended in order
+     */
+    bool orderIndependent = false;
+
+    TransparencyBuffer transparency;
+
+    /**
+     * A translucent triangle was accumulated since the last resolve
+     */
+    bool transparencyPending = false;
+
+    JobSystem *jobs = &JobSystem::shared();
+
+    /**
+     * Transient data of the pipeline: setups, bins and resolve planes. drawTriangles and resolve release it when
+     * they return, so past the first frames drawing doesn't allocate.
+     */
+    FrameArena frameArena;
+
+    /**
+     * Screen space position with the depth kept
+     * @param p
+     * @return
+     */
+    [[nodiscard]] inline Vec3 project(const Point &p) const
+    {
+        auto v = mtRes * Vec4(p.toVec3(), 1);
+        v.multiple(1 / v[3]);
+        return Vec3(v);
+    }
+
+    [[nodiscard]] inline iVec3 transform(const Point &p) const
+    {
+        return iVec3(round(project(p)));
+    }
+
+    /**
+     * Rasterize forward-shaded triangles binned into tileSize x tileSize tiles, one tile per job
+     * @param depths projected depths of the vertices of each setup, for the translucent ones
+     */
+    void rasterizeTiles(std::span<const TriangleSetup> setups, std::span<const std::array<Real, 3>> depths);
+
+    /**
+     * Screen position snapped to the 28.4 grid of the rasterizer
+     */
+    static FVec2 snapFixed(double x, double y);
+
+    static inline FVec2 snapFixed(const Vec3 &v)
+    {
+        return snapFixed(v.getX(), v.getY());
+    }
+
+    /**
+     * Clip a triangle reaching beyond the guard band, and call emit(setup, z0, z1, z2) for each triangle of the
+     * clipped polygon that covers something
+     */
+    template<typename Emit>
+    static void setupClipped(const std::array<ClipVertex, 3> &triangle, Emit &&emit);
+
+    /**
+     * Send a set up triangle to the path of the current mode
+     */
+    void rasterize(const TriangleSetup &setup, Real z0, Real z1, Real z2);
+
+    /**
+     * Geometry pass of the deferred mode: depth test the triangle into the G-buffer
+     */
+    void rasterizeDeferred(const TriangleSetup &setup, Real z0, Real z1, Real z2, uint32_t id);
+
+    void resolveDeferred();
+
+    /**
+     * Accumulate a translucent triangle into the transparency buffer
+     */
+    void rasterizeTransparent(const TriangleSetup &setup, Real z0, Real z1, Real z2);
+
+    /**
+     * Composite the transparency buffer over the image, in parallel over rows
+     */
+    void resolveTransparency();
+
+    /**
+     * Whether setup goes to the transparency buffer
+     */
+    [[nodiscard]] inline bool accumulates(const TriangleSetup &setup) const
+    {
+        return orderIndependent && !setup.opaque();
+    }
+
+    /**
+     * Coverage is tested per sample, color is shaded once per pixel
+     */
+    void rasterizeMultisample(const TriangleSetup &setup);
+
+    /**
+     * Wu's anti-aliased line: two pixels per column of the major axis, weighted by their distance to the line
+     */
+    void drawSmoothLine(double x0, double y0, TGAColor c0, double x1, double y1, TGAColor c1);
+
+    /**
+     * Mix c over the pixel, coverage in [0, 256]
+     */
+    void blendPixel(int x, int y, const TGAColor &c, int coverage);
+
+    /**
+     * Write a fully covered pixel, to every sample when multisampling
+     */
+    inline void plot(int x, int y, const TGAColor &c)
+    {
+        if (samples.empty())
+        {
+            set(x, y, c);
+        } else if (x >= 0 && y >= 0 && x < width && y < height)
+        {
+            samples.writeAll(x, y, c);
+        }
+    }
+
+public:
+    Image(int width, int height, const Mat4 &mtProj, const Mat4 &mtCam)
+            : TGAImage(width, height, TGAImage::RGB), wSign(1)
+    {
+        setCamera(mtProj, mtCam);
+    }
+
+    /**
+     * Replace the projection and camera used by the following draws
+     * @param mtProj
+     * @param mtCam
+     */
+    void setCamera(const Mat4 &mtProj, const Mat4 &mtCam)
+    {
+        mtClip = mtProj * mtCam;
+        mtRes = makeViewportTrans(width, height) * mtClip;
+        wSign = (mtProj * Vec4(0, 0, -1, 1))[3] < 0 ? -1 : 1;
+        frustum = Frustum(mtClip, wSign);
+    }
+
+    [[nodiscard]] inline const Mat4 &getClipTransform() const
+    {
+        return mtClip;
+    }
+
+    [[nodiscard]] inline Real getWSign() const
+    {
+        return wSign;
+    }
+
+    /**
+     * View volume of the current camera in world space, for culling before any vertex work
+     */
+    [[nodiscard]] inline const Frustum &getFrustum() const
+    {
+        return frustum;
+    }
+
+    /**
+     * Pool running the parallel stages: batch transform and setup, binning, tiles and resolves.
+     * The shared pool by default.
+     * @param system must outlive the image
+     */
+    inline void setJobSystem(JobSystem &system)
+    {
+        jobs = &system;
+    }
+
+    [[nodiscard]] inline JobSystem &getJobSystem() const
+    {
+        return *jobs;
+    }
+
+    void setShadingMode(ShadingMode mode);
+
+    [[nodiscard]] inline ShadingMode getShadingMode() const
+    {
+        return shadingMode;
+    }
+
+    /**
+     * Enable multisample anti-aliasing with 4 or 8 samples per pixel, or disable it with 1.
+     * What is already drawn is kept; resolve() filters the samples into the image.
+     * @param count
+     * @param filter
+     */
+    void setMultisample(int count, SampleBuffer::Filter filter = SampleBuffer::Filter::Box);
+
+    [[nodiscard]] inline int getSampleCount() const
+    {
+        return samples.empty() ? 1 : samples.count();
+    }
+
+    /**
+     * How forward shaded triangles combine with what is drawn, multisampled or not. Replace, the default, ignores
+     * alpha; the others blend each triangle in the order it is drawn. The deferred mode shades only the closest
+     * fragment of each pixel and always replaces.
+     */
+    void setBlendMode(BlendMode mode);
+
+    [[nodiscard]] inline BlendMode getBlendMode() const
+    {
+        return blendMode;
+    }
+
+    /**
+     * Order-independent transparency: triangles with a vertex alpha under 255 are accumulated, weighted by depth,
+     * and composited over the image by resolve() whatever order they were drawn in, so they need no sorting.
+     * Opaque triangles are drawn as usual, in any mode. The layers are put over everything drawn opaque, so they
+     * should be in front of it, as overlays and effects usually are.
+     * @param enable
+     */
+    void setOrderIndependent(bool enable);
+
+    [[nodiscard]] inline bool isOrderIndependent() const
+    {
+        return orderIndependent;
+    }
+
+    /**
+     * Start a new frame: clear the image to black, or to c, with its samples, and drop what the G-buffer and the
+     * transparency buffer hold. TGAImage::clear alone would leave them for the next resolve to bring back.
+     */
+    void clear();
+
+    void clear(const TGAColor &c);
+
+    void draw(const Point &point)
+    {
+        auto p = transform(point);
+        plot(p.getX(), p.getY(), point.color);
+    }
+
+    /**
+     * Draw lines with Wu's anti-aliasing instead of the aliased midpoint walk
+     * @param smooth
+     */
+    void setLineSmoothing(bool smooth);
+
+    void draw(const Line &line);
+
+    /**
+     * Lines are clipped to the image before being walked and written straight into the framebuffer
+     */
+    void draw(int x0, int y0, TGAColor c0, int x1, int y1, TGAColor c1);
+
+    void draw(const Triangle &triangle);
+
+    void
+    draw(int x0, int y0, const TGAColor &c0, int x1, int y1, const TGAColor &c1, int x2, int y2, const TGAColor &c2);
+
+    /**
+     * Batch submission: vertices are transformed in one pass, primitives behind the camera or off screen are culled,
+     * and triangles are binned into tiles rasterized in parallel with their setup shared across tiles.
+     * Apart from the culled primitives, the result is the one of drawing them one by one, in order.
+     */
+    void drawPoints(std::span<const Point> points);
+
+    void drawLines(std::span<const Line> lines);
+
+    void drawTriangles(std::span<const Triangle> triangles);
+
+    /**
+     * Shading pass of the deferred mode, run in parallel over rows. Every pixel covered by a triangle is shaded
+     * exactly once; the G-buffer is emptied afterwards. Points and lines are always drawn forward, so overlays
+     * should be drawn after resolving.
+     * When multisampling, the samples are then filtered into the image. Order-independent layers are composited
+     * last.
+     */
+    void resolve();
+
+    /**
+     * Resolve, then write the image as a TGA file, bottom row first
+     * @return false if the file can't be written
+     */
+    bool save(const char *filename);
+};
+
+#endif //CG_IMAGE_H
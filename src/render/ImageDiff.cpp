@@ -0,0 +1,139 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <vector>
+#include "ImageDiff.h"
+
+namespace
+{
+    /**
+     * Sums of one range of rows
+     */
+    struct RowStats
+    {
+        int maxError = 0;
+        uint64_t squares = 0;
+        size_t mismatched = 0;
+    };
+
+    /**
+     * Absolute differences of a row into d, and their max and sum of squares
+     */
+    inline void diffRow(const unsigned char *__restrict a, const unsigned char *__restrict b,
+                        unsigned char *__restrict d, size_t n, RowStats &stats)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            d[i] = static_cast<unsigned char>(std::max(a[i], b[i]) - std::min(a[i], b[i]));
+        }
+        unsigned char rowMax = 0;
+        // At most 15360 bytes per 4K RGBA row: the squares fit 32 bits
+        uint32_t squares = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            rowMax = std::max(rowMax, d[i]);
+            squares += static_cast<uint32_t>(d[i]) * d[i];
+        }
+        stats.maxError = std::max(stats.maxError, static_cast<int>(rowMax));
+        stats.squares += squares;
+    }
+
+    /**
+     * Flag in mask the pixels of a row of differences with a channel over tolerance
+     * @return number of flagged pixels
+     */
+    template<int Bpp>
+    inline size_t mismatchRow(const unsigned char *__restrict d, unsigned char *__restrict mask, size_t pixels,
+                              unsigned char tolerance)
+    {
+        size_t count = 0;
+        for (size_t p = 0; p < pixels; ++p)
+        {
+            unsigned char over = 0;
+            for (int c = 0; c < Bpp; ++c)
+            {
+                over |= d[p * Bpp + c] > tolerance;
+            }
+            mask[p] = over;
+            count += over;
+        }
+        return count;
+    }
+
+    size_t mismatchRow(int bpp, const unsigned char *d, unsigned char *mask, size_t pixels, unsigned char tolerance)
+    {
+        switch (bpp)
+        {
+            case 1:
+                return mismatchRow<1>(d, mask, pixels, tolerance);
+            case 3:
+                return mismatchRow<3>(d, mask, pixels, tolerance);
+            default:
+                return mismatchRow<4>(d, mask, pixels, tolerance);
+        }
+    }
+}
+
+bool compareImages(TGAImage &a, TGAImage &b, int tolerance, ImageDiff &result, TGAImage *diff, JobSystem &jobs)
+{
+    int width = a.get_width(), height = a.get_height(), bpp = a.get_bytespp();
+    if (width != b.get_width() || height != b.get_height() || bpp != b.get_bytespp() ||
+        (bpp != 1 && bpp != 3 && bpp != 4))
+    {
+        return false;
+    }
+    if (diff)
+    {
+        *diff = TGAImage(width, height, TGAImage::RGB);
+    }
+    auto tol = static_cast<unsigned char>(std::clamp(tolerance, 0, 255));
+    size_t stride = static_cast<size_t>(width) * bpp;
+    const unsigned char *pa = a.buffer(), *pb = b.buffer();
+    unsigned char *pd = diff ? diff->buffer() : nullptr;
+    RowStats total;
+    std::mutex lock;
+    jobs.parallelFor(0, height, [&](size_t yBegin, size_t yEnd)
+    {
+        RowStats stats;
+        std::vector<unsigned char> d(stride), mask(width);
+        for (size_t y = yBegin; y < yEnd; ++y)
+        {
+            auto ra = pa + y * stride, rb = pb + y * stride;
+            diffRow(ra, rb, d.data(), stride, stats);
+            stats.mismatched += mismatchRow(bpp, d.data(), mask.data(), width, tol);
+            if (!pd)
+            {
+                continue;
+            }
+            auto out = pd + y * static_cast<size_t>(width) * 3;
+            for (int x = 0; x < width; ++x)
+            {
+                // Gray level of a at a third of its brightness, under red for the mismatches
+                unsigned sum = 0;
+                for (int c = 0; c < bpp && c < 3; ++c)
+                {
+                    sum += ra[x * bpp + c];
+                }
+                auto gray = static_cast<unsigned char>(sum / (3u * std::min(bpp, 3)));
+                out[x * 3] = mask[x] ? 0 : gray;
+                out[x * 3 + 1] = mask[x] ? 0 : gray;
+                out[x * 3 + 2] = mask[x] ? 255 : gray;
+            }
+        }
+        std::lock_guard guard(lock);
+        total.maxError = std::max(total.maxError, stats.maxError);
+        total.squares += stats.squares;
+        total.mismatched += stats.mismatched;
+    });
+    result.maxError = total.maxError;
+    result.mismatched = total.mismatched;
+    result.pixels = static_cast<size_t>(width) * height;
+    double mse = result.pixels ? static_cast<double>(total.squares) / static_cast<double>(stride * height) : 0;
+    result.psnr = mse == 0 ? std::numeric_limits<double>::infinity() : 10 * std::log10(255.0 * 255.0 / mse);
+    return true;
+}
@@ -0,0 +1,44 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_IMAGEDIFF_H
+#define CG_IMAGEDIFF_H
+
+#include <cstddef>
+#include <cstdint>
+#include "job/JobSystem.h"
+#include "tgaimage/tgaimage.h"
+
+/**
+ * Per-channel comparison of two images of the same size and format
+ */
+struct ImageDiff
+{
+    /**
+     * Largest difference of a channel, 0 to 255
+     */
+    int maxError = 0;
+    /**
+     * Peak signal to noise ratio in dB over all channels, infinite for identical images
+     */
+    double psnr = 0;
+    /**
+     * Pixels with a channel differing by more than the tolerance
+     */
+    size_t mismatched = 0;
+    size_t pixels = 0;
+};
+
+/**
+ * Compare a to b. Rows are split across jobs, and each row goes through branch free byte loops the compiler
+ * vectorizes, so a 4K comparison takes a few milliseconds.
+ * @param tolerance channel difference still counted as a match
+ * @param diff if not null, made the size of a with mismatched pixels in red over a darkened gray copy of a
+ * @param jobs
+ * @return false, leaving result untouched, if the sizes or formats differ
+ */
+bool compareImages(TGAImage &a, TGAImage &b, int tolerance, ImageDiff &result, TGAImage *diff = nullptr,
+                   JobSystem &jobs = JobSystem::shared());
+
+#endif //CG_IMAGEDIFF_H
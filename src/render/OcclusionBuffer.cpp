@@ -0,0 +1,246 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include "OcclusionBuffer.h"
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+        : width(width), height(height),
+          depth(static_cast<size_t>(width) * height, -std::numeric_limits<float>::infinity())
+{
+    assert(width > 0 && height > 0);
+}
+
+void OcclusionBuffer::begin(const Mat4 &mtClip, Real wSign)
+{
+    Mat4 m = makeViewportTrans(width, height) * mtClip;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            transform[i * 4 + j] = m[i][j];
+        }
+    }
+    this->wSign = wSign;
+    std::fill(depth.begin(), depth.end(), -std::numeric_limits<float>::infinity());
+}
+
+bool OcclusionBuffer::project(const Vec3 &p, Real &x, Real &y, Real &z) const
+{
+    const auto &m = transform;
+    Real w = m[12] * p[0] + m[13] * p[1] + m[14] * p[2] + m[15];
+    if (w * wSign <= 0)
+    {
+        return false;
+    }
+    Real inv = 1 / w;
+    x = (m[0] * p[0] + m[1] * p[1] + m[2] * p[2] + m[3]) * inv;
+    y = (m[4] * p[0] + m[5] * p[1] + m[6] * p[2] + m[7]) * inv;
+    z = (m[8] * p[0] + m[9] * p[1] + m[10] * p[2] + m[11]) * inv;
+    return true;
+}
+
+bool OcclusionBuffer::halfPlane(const Projected &p, const Projected &q, const Projected &inside, HalfPlane &plane)
+{
+    Real side = (q.x - p.x) * (inside.y - p.y) - (q.y - p.y) * (inside.x - p.x);
+    if (side == 0 || !std::isfinite(side))
+    {
+        return false;
+    }
+    Real s = side > 0 ? 1 : -1;
+    plane.a = s * (p.y - q.y);
+    plane.b = s * (q.x - p.x);
+    plane.c = s * (p.x * q.y - q.x * p.y) - (std::abs(plane.a) + std::abs(plane.b)) / 2;
+    return true;
+}
+
+void OcclusionBuffer::fill(std::span<const HalfPlane> planes, Real yLow, Real yHigh, float z)
+{
+    int y0 = std::max(0, static_cast<int>(std::ceil(yLow))),
+            y1 = std::min(height - 1, static_cast<int>(std::floor(yHigh)));
+    for (int py = y0; py <= y1; ++py)
+    {
+        // Intersect the half planes along the row
+        Real left = 0, right = static_cast<Real>(width - 1);
+        bool empty = false;
+        for (auto &plane: planes)
+        {
+            Real rest = plane.b * static_cast<Real>(py) + plane.c;
+            if (plane.a > 0)
+            {
+                left = std::max(left, -rest / plane.a);
+            } else if (plane.a < 0)
+            {
+                right = std::min(right, -rest / plane.a);
+            } else if (rest < 0)
+            {
+                empty = true;
+            }
+        }
+        if (empty || !(left <= right))
+        {
+            continue;
+        }
+        auto row = depth.data() + static_cast<size_t>(py) * width;
+        int begin = static_cast<int>(std::ceil(left)), end = static_cast<int>(std::floor(right));
+        for (int px = begin; px <= end; ++px)
+        {
+            row[px] = std::max(row[px], z);
+        }
+    }
+}
+
+void OcclusionBuffer::addOccluder(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2)
+{
+    std::array<Projected, 3> v{};
+    for (int i = 0; i < 3; ++i)
+    {
+        v[i].valid = project(i == 0 ? p0 : i == 1 ? p1 : p2, v[i].x, v[i].y, v[i].z);
+        if (!v[i].valid)
+        {
+            return;
+        }
+    }
+    std::array<HalfPlane, 3> planes{};
+    for (int i = 0; i < 3; ++i)
+    {
+        if (!halfPlane(v[(i + 1) % 3], v[(i + 2) % 3], v[i], planes[i]))
+        {
+            return;
+        }
+    }
+    fill(planes, std::min({v[0].y, v[1].y, v[2].y}), std::max({v[0].y, v[1].y, v[2].y}),
+         static_cast<float>(std::min({v[0].z, v[1].z, v[2].z})));
+}
+
+void OcclusionBuffer::addOccluder(std::span<const Vec3> positions, std::span<const uint32_t> indices)
+{
+    projected.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        auto &v = projected[i];
+        v.valid = project(positions[i], v.x, v.y, v.z);
+    }
+    size_t triangles = indices.size() / 3;
+    edges.clear();
+    for (size_t t = 0; t < triangles; ++t)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            uint32_t a = indices[t * 3 + (i + 1) % 3], b = indices[t * 3 + (i + 2) % 3];
+            edges.push_back(MeshEdge{std::min(a, b), std::max(a, b), static_cast<uint32_t>(t)});
+        }
+    }
+    auto key = [](const MeshEdge &e) { return std::tie(e.v0, e.v1); };
+    std::sort(edges.begin(), edges.end(), [&](const MeshEdge &l, const MeshEdge &r) { return key(l) < key(r); });
+    for (size_t t = 0; t < triangles; ++t)
+    {
+        const uint32_t *tri = indices.data() + t * 3;
+        if (!projected[tri[0]].valid || !projected[tri[1]].valid || !projected[tri[2]].valid)
+        {
+            continue;
+        }
+        // Up to two planes per edge: the edge of the triangle, or the two far edges of the neighbour across it, so
+        // that pixels straddling the edge pass when the two triangles together cover them
+        std::array<HalfPlane, 6> planes{};
+        size_t count = 0;
+        Real yLow = std::numeric_limits<Real>::max(), yHigh = std::numeric_limits<Real>::lowest();
+        Real farthest = std::numeric_limits<Real>::max();
+        bool degenerate = false;
+        for (int i = 0; i < 3 && !degenerate; ++i)
+        {
+            uint32_t a = tri[(i + 1) % 3], b = tri[(i + 2) % 3];
+            const auto &va = projected[a], &vb = projected[b], &vi = projected[tri[i]];
+            yLow = std::min(yLow, vi.y);
+            yHigh = std::max(yHigh, vi.y);
+            farthest = std::min(farthest, vi.z);
+            MeshEdge shared{std::min(a, b), std::max(a, b), 0};
+            auto range = std::equal_range(edges.begin(), edges.end(), shared,
+                                          [&](const MeshEdge &l, const MeshEdge &r) { return key(l) < key(r); });
+            bool joined = false;
+            for (auto e = range.first; e != range.second && !joined; ++e)
+            {
+                if (e->triangle == t)
+                {
+                    continue;
+                }
+                const uint32_t *other = indices.data() + static_cast<size_t>(e->triangle) * 3;
+                uint32_t o = other[0] != a && other[0] != b ? other[0] : other[1] != a && other[1] != b ? other[1]
+                                                                                                      : other[2];
+                const auto &vo = projected[o];
+                Real sideI = (vb.x - va.x) * (vi.y - va.y) - (vb.y - va.y) * (vi.x - va.x);
+                Real sideO = (vb.x - va.x) * (vo.y - va.y) - (vb.y - va.y) * (vo.x - va.x);
+                // Only a neighbour on the other side of the edge extends the triangle across it
+                if (!vo.valid || !(sideI * sideO < 0) || !halfPlane(vb, vo, va, planes[count]) ||
+                    !halfPlane(vo, va, vb, planes[count + 1]))
+                {
+                    continue;
+                }
+                count += 2;
+                yLow = std::min(yLow, vo.y);
+                yHigh = std::max(yHigh, vo.y);
+                farthest = std::min(farthest, vo.z);
+                joined = true;
+            }
+            if (!joined)
+            {
+                degenerate = !halfPlane(va, vb, vi, planes[count++]);
+            }
+        }
+        if (!degenerate)
+        {
+            fill(std::span(planes.data(), count), yLow, yHigh, static_cast<float>(farthest));
+        }
+    }
+}
+
+bool OcclusionBuffer::isOccluded(const AABB &box) const
+{
+    if (box.empty())
+    {
+        return false;
+    }
+    Real xMin = std::numeric_limits<Real>::max(), xMax = std::numeric_limits<Real>::lowest();
+    Real yMin = xMin, yMax = xMax, closest = xMax;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        Vec3 p{corner & 1 ? box.max[0] : box.min[0], corner & 2 ? box.max[1] : box.min[1],
+               corner & 4 ? box.max[2] : box.min[2]};
+        Real x, y, z;
+        if (!project(p, x, y, z))
+        {
+            // Crosses the camera plane: the projection of the box is unbounded
+            return false;
+        }
+        xMin = std::min(xMin, x);
+        xMax = std::max(xMax, x);
+        yMin = std::min(yMin, y);
+        yMax = std::max(yMax, y);
+        closest = std::max(closest, z);
+    }
+    // Pixel p spans [p - 0.5, p + 0.5)
+    int x0 = std::max(0, static_cast<int>(std::floor(xMin + Real(0.5)))),
+            x1 = std::min(width - 1, static_cast<int>(std::floor(xMax + Real(0.5))));
+    int y0 = std::max(0, static_cast<int>(std::floor(yMin + Real(0.5)))),
+            y1 = std::min(height - 1, static_cast<int>(std::floor(yMax + Real(0.5))));
+    if (x0 > x1 || y0 > y1)
+    {
+        return false;
+    }
+    auto z = static_cast<float>(closest);
+    for (int py = y0; py <= y1; ++py)
+    {
+        auto row = depth.data() + static_cast<size_t>(py) * width;
+        float nearest = *std::min_element(row + x0, row + x1 + 1);
+        if (!(nearest > z))
+        {
+            return false;
+        }
+    }
+    return true;
+}
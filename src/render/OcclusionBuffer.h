@@ -0,0 +1,132 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_OCCLUSIONBUFFER_H
+#define CG_OCCLUSIONBUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "linear/Vec.h"
+#include "linear/Mat.h"
+#include "linear/Bounds.h"
+
+/**
+ * Coarse depth buffer for occlusion culling, filled with a few large occluders before the main pass and queried
+ * with the bounding boxes of the other objects.
+ * Both sides are conservative, so culling never removes a visible object: an occluder only writes the pixels it
+ * covers entirely, at the depth of its farthest vertex, and a box is hidden only if every pixel its projection
+ * touches holds an occluder closer than the box's closest corner. Within a mesh, a pixel across an edge shared by
+ * two triangles counts as covered when the two cover it together, so the inner edges of an occluder don't leave a
+ * line of holes.
+ * Depth follows the renderer: greater is closer. Rows are walked as spans over contiguous floats, which the compiler
+ * vectorizes.
+ */
+class OcclusionBuffer
+{
+public:
+    static constexpr int defaultWidth = 256;
+    static constexpr int defaultHeight = 128;
+
+    explicit OcclusionBuffer(int width = defaultWidth, int height = defaultHeight);
+
+    /**
+     * Clear the buffer and set the camera of the following occluders and tests
+     * @param mtClip projection times camera
+     * @param wSign sign of w in front of the camera
+     */
+    void begin(const Mat4 &mtClip, Real wSign);
+
+    /**
+     * Rasterize a world space triangle as an occluder. Triangles crossing the camera plane are skipped.
+     */
+    void addOccluder(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2);
+
+    /**
+     * Rasterize an indexed world space mesh as an occluder, every three indices a triangle. Triangles crossing the
+     * camera plane are skipped.
+     */
+    void addOccluder(std::span<const Vec3> positions, std::span<const uint32_t> indices);
+
+    /**
+     * @return true if the world space box is certainly hidden behind the occluders
+     */
+    [[nodiscard]] bool isOccluded(const AABB &box) const;
+
+    [[nodiscard]] inline int getWidth() const
+    {
+        return width;
+    }
+
+    [[nodiscard]] inline int getHeight() const
+    {
+        return height;
+    }
+
+    [[nodiscard]] inline float depthAt(int x, int y) const
+    {
+        return depth[static_cast<size_t>(y) * width + x];
+    }
+
+private:
+    /**
+     * Inside where a x + b y + c >= 0
+     */
+    struct HalfPlane
+    {
+        Real a, b, c;
+    };
+
+    /**
+     * Screen position and depth of a mesh vertex, valid if in front of the camera
+     */
+    struct Projected
+    {
+        Real x, y, z;
+        bool valid;
+    };
+
+    /**
+     * Edge of a mesh triangle, vertices in increasing order
+     */
+    struct MeshEdge
+    {
+        uint32_t v0, v1;
+        uint32_t triangle;
+    };
+
+    int width, height;
+    /**
+     * Viewport times clip transform, row major
+     */
+    std::array<Real, 16> transform{};
+    Real wSign = 1;
+    std::vector<float> depth;
+    /**
+     * Scratch of the mesh occluders, kept to reuse its capacity
+     */
+    std::vector<Projected> projected;
+    std::vector<MeshEdge> edges;
+
+    /**
+     * Screen position and depth of p in the coarse buffer
+     * @return false if p is not in front of the camera
+     */
+    bool project(const Vec3 &p, Real &x, Real &y, Real &z) const;
+
+    /**
+     * Half plane bounded by the line through p and q on the side of inside, moved in by half a pixel so that a pixel
+     * passes only if its whole square is on that side
+     * @return false if inside is on the line
+     */
+    static bool halfPlane(const Projected &p, const Projected &q, const Projected &inside, HalfPlane &plane);
+
+    /**
+     * Write depth z to the pixels in rows [yLow, yHigh] inside every plane, unless they hold a closer one
+     */
+    void fill(std::span<const HalfPlane> planes, Real yLow, Real yHigh, float z);
+};
+
+#endif //CG_OCCLUSIONBUFFER_H
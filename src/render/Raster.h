@@ -0,0 +1,338 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_RASTER_H
+#define CG_RASTER_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include "linear/Vec.h"
+#include "linear/Fixed.h"
+#include "tgaimage/tgaimage.h"
+
+/**
+ * Everything the triangle rasterizer needs, computed once per triangle so it can be reused for every tile the
+ * triangle overlaps.
+ * Vertices are snapped to 28.4 fixed point and edge functions are evaluated in 64-bit integers at pixel centres,
+ * which lie on integer coordinates. Vertices must lie within the guard band, where no edge value can overflow:
+ * larger triangles are clipped to it first, see clipToGuardBand. Every edge value and area is then exact in 64 bits,
+ * so the setup needs no wider arithmetic such as Number. Coverage follows the top-left rule, so triangles
+ * sharing an edge neither overlap nor leave cracks.
+ * Edge i is the edge opposite to vertex i, so its value over the doubled area is the barycentric weight of vertex i.
+ */
+struct TriangleSetup
+{
+    /**
+     * Pixels whose centre can be inside
+     */
+    int xMin{}, xMax{}, yMin{}, yMax{};
+    long long area{};
+    std::array<long long, 3> a{}, b{}, c{};
+    /**
+     * Smallest edge value counted as inside: 0 on top-left edges, 1 elsewhere
+     */
+    std::array<long long, 3> minE{};
+    TGAColor c0, c1, c2;
+
+    /**
+     * @return false for a degenerate triangle, which covers nothing
+     */
+    bool setup(const FVec2 &v0, const TGAColor &col0, const FVec2 &v1, const TGAColor &col1,
+               const FVec2 &v2, const TGAColor &col2)
+    {
+        int x0 = v0[0].raw(), y0 = v0[1].raw(), x1 = v1[0].raw(), y1 = v1[1].raw(), x2 = v2[0].raw(),
+                y2 = v2[1].raw();
+        int rxMin = std::min({x0, x1, x2}), rxMax = std::max({x0, x1, x2}),
+                ryMin = std::min({y0, y1, y2}), ryMax = std::max({y0, y1, y2});
+        xMin = Fixed28p4::fromRaw(rxMin).ceil();
+        xMax = Fixed28p4::fromRaw(rxMax).floor();
+        yMin = Fixed28p4::fromRaw(ryMin).ceil();
+        yMax = Fixed28p4::fromRaw(ryMax).floor();
+        c0 = col0;
+        c1 = col1;
+        c2 = col2;
+        assert(std::max({-rxMin, rxMax, -ryMin, ryMax}) < fastLimit && "clip to the guard band before snapping");
+        auto edge = [this](int i, long long xa, long long ya, long long xb, long long yb)
+        {
+            a[i] = ya - yb;
+            b[i] = xb - xa;
+            c[i] = xa * yb - xb * ya;
+        };
+        edge(0, x1, y1, x2, y2);
+        edge(1, x2, y2, x0, y0);
+        edge(2, x0, y0, x1, y1);
+        area = a[0] * x0 + b[0] * y0 + c[0];
+        orient();
+        for (int i = 0; i < 3; ++i)
+        {
+            // (a, b) is the inward normal: left edges face +x, top edges are horizontal and face -y, as y points up
+            // once the image is flipped for saving
+            bool topLeft = a[i] > 0 || (a[i] == 0 && b[i] < 0);
+            minE[i] = topLeft ? 0 : 1;
+        }
+        return area != 0;
+    }
+
+    /**
+     * Visit the pixels inside the triangle and within [x0, x1] x [y0, y1]. Edge values are stepped
+     * incrementally from the corner of the rectangle.
+     * @param visit called as visit(x, y, w0, w1, w2) with the barycentric weights of the pixel
+     */
+    template<typename Visit>
+    void rasterize(int x0, int y0, int x1, int y1, Visit &&visit) const
+    {
+        x0 = std::max(x0, xMin);
+        x1 = std::min(x1, xMax);
+        y0 = std::max(y0, yMin);
+        y1 = std::min(y1, yMax);
+        if (x0 > x1 || y0 > y1)
+        {
+            return;
+        }
+        auto inv = 1 / static_cast<Real>(area);
+        std::array<long long, 3> row = at(x0, y0), dx{}, dy{};
+        for (int i = 0; i < 3; ++i)
+        {
+            dx[i] = a[i] * Fixed28p4::one;
+            dy[i] = b[i] * Fixed28p4::one;
+        }
+        for (int y = y0; y <= y1; ++y)
+        {
+            long long e0 = row[0], e1 = row[1], e2 = row[2];
+            for (int x = x0; x <= x1; ++x)
+            {
+                if (e0 >= minE[0] && e1 >= minE[1] && e2 >= minE[2])
+                {
+                    visit(x, y, static_cast<Real>(e0) * inv, static_cast<Real>(e1) * inv,
+                          static_cast<Real>(e2) * inv);
+                }
+                e0 += dx[0];
+                e1 += dx[1];
+                e2 += dx[2];
+            }
+            row[0] += dy[0];
+            row[1] += dy[1];
+            row[2] += dy[2];
+        }
+    }
+
+    /**
+     * Multisample variant: coverage is tested at each sample position, given in 1/16 pixel offsets from the centre,
+     * and pixels with any sample covered are visited once.
+     * @param visit called as visit(x, y, mask, w0, w1, w2) with the weights at the pixel centre, which may be
+     * negative on edge pixels
+     */
+    template<typename Visit>
+    void rasterizeSamples(int x0, int y0, int x1, int y1, const std::array<int, 2> *offsets, int count,
+                          Visit &&visit) const
+    {
+        // Samples are less than one pixel away from the centre
+        x0 = std::max(x0, xMin - 1);
+        x1 = std::min(x1, xMax + 1);
+        y0 = std::max(y0, yMin - 1);
+        y1 = std::min(y1, yMax + 1);
+        if (x0 > x1 || y0 > y1)
+        {
+            return;
+        }
+        std::array<std::array<long long, 3>, 8> delta{};
+        for (int s = 0; s < count; ++s)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                delta[s][i] = a[i] * offsets[s][0] + b[i] * offsets[s][1];
+            }
+        }
+        auto inv = 1 / static_cast<Real>(area);
+        for (int y = y0; y <= y1; ++y)
+        {
+            auto e = at(x0, y);
+            for (int x = x0; x <= x1; ++x)
+            {
+                unsigned mask = 0;
+                for (int s = 0; s < count; ++s)
+                {
+                    if (e[0] + delta[s][0] >= minE[0] && e[1] + delta[s][1] >= minE[1] &&
+                        e[2] + delta[s][2] >= minE[2])
+                    {
+                        mask |= 1u << s;
+                    }
+                }
+                if (mask)
+                {
+                    visit(x, y, mask, static_cast<Real>(e[0]) * inv, static_cast<Real>(e[1]) * inv,
+                          static_cast<Real>(e[2]) * inv);
+                }
+                for (int i = 0; i < 3; ++i)
+                {
+                    e[i] += a[i] * Fixed28p4::one;
+                }
+            }
+        }
+    }
+
+    /**
+     * Every vertex has alpha 255, so no fragment lets what is behind show through
+     */
+    [[nodiscard]] inline bool opaque() const
+    {
+        return c0.a == 255 && c1.a == 255 && c2.a == 255;
+    }
+
+    /**
+     * Color interpolated from the vertex colors
+     */
+    [[nodiscard]] inline TGAColor shade(Real w0, Real w1, Real w2) const
+    {
+        return {blend(w0, c0.r, w2, c2.r, w1, c1.r), blend(w0, c0.g, w2, c2.g, w1, c1.g),
+                blend(w0, c0.b, w2, c2.b, w1, c1.b), blend(w0, c0.a, w2, c2.a, w1, c1.a)};
+    }
+
+private:
+    /**
+     * Coordinates in 28.4 units under which no edge value can reach 2^63
+     */
+    static constexpr int fastLimit = 1 << 29;
+
+    /**
+     * Edge values at the centre of pixel (x, y)
+     */
+    [[nodiscard]] inline std::array<long long, 3> at(int x, int y) const
+    {
+        long long fx = static_cast<long long>(x) * Fixed28p4::one, fy = static_cast<long long>(y) * Fixed28p4::one;
+        return {a[0] * fx + b[0] * fy + c[0], a[1] * fx + b[1] * fy + c[1], a[2] * fx + b[2] * fy + c[2]};
+    }
+
+    /**
+     * Orient every edge so the inside is positive whatever the winding
+     */
+    void orient()
+    {
+        if (area < 0)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                a[i] = -a[i];
+                b[i] = -b[i];
+                c[i] = -c[i];
+            }
+            area = -area;
+        }
+    }
+
+    static inline unsigned char blend(Real wa, unsigned char ca, Real wb, unsigned char cb, Real wc,
+                                      unsigned char cc)
+    {
+        return static_cast<unsigned char>(wa * ca + wb * cb + wc * cc);
+    }
+};
+
+/**
+ * Half size in pixels of the square around the image origin that triangles are clipped to before snapping.
+ * It is far larger than any image, so clipping never moves an edge crossing the image, and its corners snapped to
+ * 28.4 stay under the limit of the 64-bit edge functions.
+ */
+constexpr double guardBand = 1 << 24;
+
+[[nodiscard]] inline bool insideGuardBand(double x, double y)
+{
+    return std::abs(x) <= guardBand && std::abs(y) <= guardBand;
+}
+
+/**
+ * Screen space vertex of a triangle to clip, with what is interpolated along its edges
+ */
+struct ClipVertex
+{
+    double x, y, z;
+    std::array<double, 4> color;
+
+    ClipVertex() = default;
+
+    ClipVertex(double x, double y, double z, const TGAColor &c)
+            : x(x), y(y), z(z), color{static_cast<double>(c.raw[0]), static_cast<double>(c.raw[1]),
+                                      static_cast<double>(c.raw[2]), static_cast<double>(c.raw[3])} {}
+
+    [[nodiscard]] inline TGAColor getColor() const
+    {
+        TGAColor c;
+        for (int i = 0; i < 4; ++i)
+        {
+            c.raw[i] = static_cast<unsigned char>(std::clamp(std::lround(color[i]), 0L, 255L));
+        }
+        c.bytespp = 4;
+        return c;
+    }
+};
+
+/**
+ * Clip a triangle to the guard band (Sutherland–Hodgman). Depth and color are interpolated linearly in screen
+ * space, as the rasterizer shades, so the clipped polygon shades the pixels of the image as the triangle would.
+ * An edge is always cut from the same end, so triangles sharing it get the same new vertex and no crack.
+ * @return vertex count of the clipped polygon, in order, 0 when nothing is left or a vertex isn't finite
+ */
+inline size_t clipToGuardBand(const std::array<ClipVertex, 3> &triangle, std::array<ClipVertex, 7> &polygon)
+{
+    for (auto &v: triangle)
+    {
+        // Projected from next to the eye plane: no edge direction to clip along
+        if (!std::isfinite(v.x) || !std::isfinite(v.y))
+        {
+            return 0;
+        }
+    }
+    std::array<ClipVertex, 7> buffer;
+    std::copy(triangle.begin(), triangle.end(), polygon.begin());
+    size_t count = 3;
+    // Planes x >= -g, x <= g, y >= -g, y <= g, as a signed distance of a vertex
+    for (int plane = 0; plane < 4; ++plane)
+    {
+        auto distance = [plane](const ClipVertex &v)
+        {
+            double d = plane < 2 ? v.x : v.y;
+            return plane % 2 ? guardBand - d : d + guardBand;
+        };
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const ClipVertex &p = polygon[i], &q = polygon[(i + 1) % count];
+            double dp = distance(p), dq = distance(q);
+            if (dp >= 0)
+            {
+                buffer[kept++] = p;
+            }
+            if ((dp >= 0) != (dq >= 0))
+            {
+                bool forward = std::tie(p.x, p.y) < std::tie(q.x, q.y);
+                const ClipVertex &from = forward ? p : q, &to = forward ? q : p;
+                double df = forward ? dp : dq, dt = forward ? dq : dp;
+                double t = df / (df - dt);
+                ClipVertex v;
+                v.x = from.x + t * (to.x - from.x);
+                v.y = from.y + t * (to.y - from.y);
+                v.z = from.z + t * (to.z - from.z);
+                for (int c = 0; c < 4; ++c)
+                {
+                    v.color[c] = from.color[c] + t * (to.color[c] - from.color[c]);
+                }
+                // Exactly on the plane, whatever the rounding of t
+                (plane < 2 ? v.x : v.y) = plane % 2 ? guardBand : -guardBand;
+                buffer[kept++] = v;
+            }
+        }
+        std::copy(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(kept), polygon.begin());
+        count = kept;
+        if (count < 3)
+        {
+            return 0;
+        }
+    }
+    return count;
+}
+
+#endif //CG_RASTER_H
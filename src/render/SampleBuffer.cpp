@@ -0,0 +1,106 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cassert>
+#include <cstdint>
+#include "SampleBuffer.h"
+
+SampleBuffer::SampleBuffer(int width, int height, int bytespp, int samples)
+        : width(width), height(height), bytespp(bytespp), samples(samples),
+          planeSize(static_cast<size_t>(width) * height * bytespp),
+          data(planeSize * samples, 0)
+{
+    assert(samples == 4 || samples == 8);
+}
+
+void SampleBuffer::fill(const unsigned char *src)
+{
+    for (int s = 0; s < samples; ++s)
+    {
+        memcpy(data.data() + s * planeSize, src, planeSize);
+    }
+}
+
+void SampleBuffer::resolve(unsigned char *dst, SampleBuffer::Filter filter, JobSystem &jobs, Arena &scratch) const
+{
+    if (filter == Filter::Box)
+    {
+        samples == 8 ? resolveBox<8>(dst, jobs) : resolveBox<4>(dst, jobs);
+    } else
+    {
+        samples == 8 ? resolveTent<8>(dst, jobs, scratch) : resolveTent<4>(dst, jobs, scratch);
+    }
+}
+
+template<int S>
+void SampleBuffer::resolveBox(unsigned char *__restrict dst, JobSystem &jobs) const
+{
+    // Fixed trip count over S planes and no cross-byte dependency: the compiler turns this into packed adds
+    constexpr int shift = S == 8 ? 3 : 2;
+    const unsigned char *__restrict src = data.data();
+    size_t stride = static_cast<size_t>(width) * bytespp;
+    jobs.parallelFor(0, height, [=, this](size_t yBegin, size_t yEnd)
+    {
+        for (size_t i = yBegin * stride; i < yEnd * stride; ++i)
+        {
+            unsigned sum = S / 2;
+            for (int s = 0; s < S; ++s)
+            {
+                sum += src[s * planeSize + i];
+            }
+            dst[i] = static_cast<unsigned char>(sum >> shift);
+        }
+    });
+}
+
+template<int S>
+void SampleBuffer::resolveTent(unsigned char *__restrict dst, JobSystem &jobs, Arena &scratch) const
+{
+    // Sums of S samples fit 11 bits; the separable [1 2 1] x [1 2 1] kernel adds 4 more, so 16 bits are enough
+    const unsigned char *__restrict src = data.data();
+    auto box = scratch.allocate<uint16_t>(planeSize), row = scratch.allocate<uint16_t>(planeSize);
+    size_t stride = static_cast<size_t>(width) * bytespp;
+    // Each pass reads the rows around its own, so the passes run one after the other, each over all rows in parallel
+    jobs.parallelFor(0, height, [&](size_t yBegin, size_t yEnd)
+    {
+        for (size_t i = yBegin * stride; i < yEnd * stride; ++i)
+        {
+            unsigned sum = 0;
+            for (int s = 0; s < S; ++s)
+            {
+                sum += src[s * planeSize + i];
+            }
+            box[i] = static_cast<uint16_t>(sum);
+        }
+    });
+    jobs.parallelFor(0, height, [&](size_t yBegin, size_t yEnd)
+    {
+        for (size_t y = yBegin; y < yEnd; ++y)
+        {
+            const uint16_t *in = box.data() + y * stride;
+            uint16_t *out = row.data() + y * stride;
+            for (size_t i = 0; i < stride; ++i)
+            {
+                size_t l = i >= static_cast<size_t>(bytespp) ? i - bytespp : i;
+                size_t r = i + bytespp < stride ? i + bytespp : i;
+                out[i] = static_cast<uint16_t>(in[l] + 2 * in[i] + in[r]);
+            }
+        }
+    });
+    constexpr unsigned norm = 16 * S;
+    jobs.parallelFor(0, height, [&](size_t yBegin, size_t yEnd)
+    {
+        for (size_t y = yBegin; y < yEnd; ++y)
+        {
+            const uint16_t *up = row.data() + (y > 0 ? y - 1 : y) * stride;
+            const uint16_t *mid = row.data() + y * stride;
+            const uint16_t *down = row.data() + (y + 1 < static_cast<size_t>(height) ? y + 1 : y) * stride;
+            unsigned char *out = dst + y * stride;
+            for (size_t i = 0; i < stride; ++i)
+            {
+                out[i] = static_cast<unsigned char>((up[i] + 2u * mid[i] + down[i] + norm / 2) / norm);
+            }
+        }
+    });
+}
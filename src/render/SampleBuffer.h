@@ -0,0 +1,146 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_SAMPLEBUFFER_H
+#define CG_SAMPLEBUFFER_H
+
+#include <array>
+#include <cstring>
+#include <vector>
+#include "job/JobSystem.h"
+#include "memory/FrameArena.h"
+#include "render/Blend.h"
+#include "tgaimage/tgaimage.h"
+
+/**
+ * Per-sample color storage for multisample anti-aliasing.
+ * Samples are kept in planes with the same byte layout as the TGAImage they resolve into, so the resolve is a
+ * straight byte-wise reduction over contiguous memory.
+ */
+class SampleBuffer
+{
+public:
+    enum class Filter
+    {
+        /**
+         * Average of the samples of the pixel
+         */
+        Box,
+        /**
+         * Box average followed by a 3x3 [1 2 1] tent over neighbouring pixels
+         */
+        Tent
+    };
+
+    SampleBuffer() = default;
+
+    /**
+     * @param samples 4 or 8
+     */
+    SampleBuffer(int width, int height, int bytespp, int samples);
+
+    /**
+     * Sample positions relative to the pixel centre, in 1/16 pixel: the 28.4 units of the rasterizer
+     */
+    [[nodiscard]] inline const std::array<int, 2> *offsets() const
+    {
+        return samples == 8 ? offsets8.data() : offsets4.data();
+    }
+
+    [[nodiscard]] inline int count() const
+    {
+        return samples;
+    }
+
+    [[nodiscard]] inline bool empty() const
+    {
+        return samples == 0;
+    }
+
+    /**
+     * Write the samples of (x, y) selected by mask
+     */
+    inline void write(int x, int y, unsigned mask, const TGAColor &c)
+    {
+        size_t at = (static_cast<size_t>(y) * width + x) * bytespp;
+        for (int s = 0; s < samples; ++s)
+        {
+            if (mask & (1u << s))
+            {
+                memcpy(data.data() + s * planeSize + at, c.raw, bytespp);
+            }
+        }
+    }
+
+    /**
+     * Blend c into the samples of (x, y) selected by mask
+     */
+    inline void write(int x, int y, unsigned mask, const TGAColor &c, BlendMode mode)
+    {
+        size_t at = (static_cast<size_t>(y) * width + x) * bytespp;
+        for (int s = 0; s < samples; ++s)
+        {
+            if (mask & (1u << s))
+            {
+                blendSpan(mode, data.data() + s * planeSize + at, &c, 1, bytespp);
+            }
+        }
+    }
+
+    inline void writeAll(int x, int y, const TGAColor &c)
+    {
+        write(x, y, (1u << samples) - 1, c);
+    }
+
+    /**
+     * Mix c over every sample of (x, y), coverage in [0, 256]
+     */
+    inline void blend(int x, int y, const TGAColor &c, int coverage)
+    {
+        size_t at = (static_cast<size_t>(y) * width + x) * bytespp;
+        for (int s = 0; s < samples; ++s)
+        {
+            unsigned char *p = data.data() + s * planeSize + at;
+            for (int i = 0; i < bytespp; ++i)
+            {
+                p[i] = static_cast<unsigned char>(p[i] + (((c.raw[i] - p[i]) * coverage) >> 8));
+            }
+        }
+    }
+
+    /**
+     * Copy an already rendered framebuffer into every sample
+     * @param src
+     */
+    void fill(const unsigned char *src);
+
+    /**
+     * Reduce the samples into dst, which has the layout of the source image, in parallel over rows
+     * @param dst
+     * @param filter
+     * @param jobs
+     * @param scratch holds the intermediate planes of the tent filter
+     */
+    void resolve(unsigned char *dst, Filter filter, JobSystem &jobs, Arena &scratch) const;
+
+private:
+    static constexpr std::array<std::array<int, 2>, 4> offsets4{{{-2, -6}, {6, -2}, {-6, 2}, {2, 6}}};
+    static constexpr std::array<std::array<int, 2>, 8> offsets8{{
+            {1, -3}, {-1, 3}, {5, 1}, {-3, -5}, {-5, 5}, {-7, -1}, {3, 7}, {7, -7}}};
+
+    int width = 0;
+    int height = 0;
+    int bytespp = 0;
+    int samples = 0;
+    size_t planeSize = 0;
+    std::vector<unsigned char> data;
+
+    template<int S>
+    void resolveBox(unsigned char *dst, JobSystem &jobs) const;
+
+    template<int S>
+    void resolveTent(unsigned char *dst, JobSystem &jobs, Arena &scratch) const;
+};
+
+#endif //CG_SAMPLEBUFFER_H
@@ -0,0 +1,110 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_TRANSPARENCYBUFFER_H
+#define CG_TRANSPARENCYBUFFER_H
+
+#include <algorithm>
+#include <vector>
+#include "tgaimage/tgaimage.h"
+
+/**
+ * Accumulation buffers of weighted blended order-independent transparency (McGuire and Bavoil, 2013).
+ * Every translucent fragment adds its premultiplied color times a weight falling off with distance to a per-pixel
+ * sum, and multiplies the pixel's revealage, the fraction of the background still seen through, by 1 - alpha.
+ * Both are commutative, so fragments can arrive in any order and from any tile; compositing then puts the weighted
+ * average color over the background in proportion to 1 - revealage. Close fragments weigh more, which approximates
+ * the sorted result where the layers differ most.
+ */
+class TransparencyBuffer
+{
+public:
+    TransparencyBuffer() = default;
+
+    TransparencyBuffer(int width, int height) { resize(width, height); }
+
+    void resize(int w, int h)
+    {
+        width = w;
+        height = h;
+        accum.resize(static_cast<size_t>(w) * h * 4);
+        revealage.resize(static_cast<size_t>(w) * h);
+        clear();
+    }
+
+    void clear()
+    {
+        std::fill(accum.begin(), accum.end(), 0.f);
+        std::fill(revealage.begin(), revealage.end(), 1.f);
+    }
+
+    /**
+     * Accumulate a fragment at pixel index i
+     * @param z depth after projection, in [-1, 1] with greater closer
+     * @param coverage fraction of the pixel covered
+     */
+    inline void add(size_t i, const TGAColor &c, float z, float coverage = 1)
+    {
+        float a = static_cast<float>(c.a) * (coverage / 255.f);
+        float near = (std::clamp(z, -1.f, 1.f) + 1) / 2;
+        float w = a * std::max(1e-2f, 3e3f * near * near * near);
+        float *sum = accum.data() + 4 * i;
+        sum[0] += static_cast<float>(c.raw[0]) * w;
+        sum[1] += static_cast<float>(c.raw[1]) * w;
+        sum[2] += static_cast<float>(c.raw[2]) * w;
+        sum[3] += w;
+        revealage[i] *= 1 - a;
+    }
+
+    /**
+     * Put the accumulated layers of rows [yBegin, yEnd) over the image dst of bytespp bytes per pixel, and empty
+     * them. Rows can be composited in parallel.
+     */
+    void composite(int yBegin, int yEnd, unsigned char *dst, int bytespp)
+    {
+        size_t begin = static_cast<size_t>(yBegin) * width, end = static_cast<size_t>(yEnd) * width;
+        // Locals, so that the byte stores can't be taken to alias them
+        float *__restrict sums = accum.data();
+        float *__restrict reveal = revealage.data();
+        unsigned char *__restrict out = dst;
+        for (size_t i = begin; i < end; ++i)
+        {
+            float r = reveal[i];
+            if (r >= 1)
+            {
+                continue;
+            }
+            float *sum = sums + 4 * i;
+            unsigned char *p = out + i * bytespp;
+            float scale = (1 - r) / std::max(sum[3], 1e-5f);
+            for (int c = 0; c < bytespp && c < 3; ++c)
+            {
+                p[c] = static_cast<unsigned char>(std::min(255.f, sum[c] * scale + p[c] * r + 0.5f));
+            }
+            if (bytespp == 4)
+            {
+                p[3] = static_cast<unsigned char>(255 - (255 - p[3]) * r + 0.5f);
+            }
+            sum[0] = sum[1] = sum[2] = sum[3] = 0;
+            reveal[i] = 1;
+        }
+    }
+
+    [[nodiscard]] inline bool empty() const { return revealage.empty(); }
+
+    [[nodiscard]] inline int getWidth() const { return width; }
+
+    [[nodiscard]] inline int getHeight() const { return height; }
+
+private:
+    int width = 0;
+    int height = 0;
+    /**
+     * Sum of weighted premultiplied b, g, r and of the weights, per pixel
+     */
+    std::vector<float> accum;
+    std::vector<float> revealage;
+};
+
+#endif //CG_TRANSPARENCYBUFFER_H
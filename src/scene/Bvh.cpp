@@ -0,0 +1,132 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <numeric>
+#include "Bvh.h"
+
+void Bvh::build(std::span<const AABB> boxes)
+{
+    nodes.clear();
+    parents.clear();
+    items.resize(boxes.size());
+    std::iota(items.begin(), items.end(), 0);
+    centers.resize(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        centers[i] = boxes[i].center();
+    }
+    leafBoxes.assign(boxes.begin(), boxes.end());
+    if (boxes.empty())
+    {
+        return;
+    }
+    nodes.reserve(2 * boxes.size() / leafSize + 1);
+    parents.reserve(nodes.capacity());
+    leaves.resize(boxes.size());
+    buildNode(0, static_cast<uint32_t>(boxes.size()), 0, noParent);
+    slots.resize(items.size());
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        leafBoxes[i] = boxes[items[i]];
+        slots[items[i]] = static_cast<uint32_t>(i);
+    }
+    listed.assign(nodes.size(), 0);
+}
+
+uint32_t Bvh::buildNode(uint32_t begin, uint32_t end, int depth, uint32_t parent)
+{
+    auto index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({});
+    parents.push_back(parent);
+    AABB box, centerBox;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        box.expand(leafBoxes[items[i]]);
+        centerBox.expand(centers[items[i]]);
+    }
+    nodes[index].box = box;
+    auto extent = centerBox.extent();
+    int axis = extent[0] > extent[1] ? (extent[0] > extent[2] ? 0 : 2) : (extent[1] > extent[2] ? 1 : 2);
+    // Depth is capped so the fixed size stack of query() can't overflow
+    if (end - begin <= leafSize || extent[axis] <= 0 || depth >= 30)
+    {
+        nodes[index].first = begin;
+        nodes[index].count = end - begin;
+        std::fill(leaves.begin() + begin, leaves.begin() + end, index);
+        return index;
+    }
+    uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+                     [this, axis](uint32_t l, uint32_t r) { return centers[l][axis] < centers[r][axis]; });
+    buildNode(begin, mid, depth + 1, index);
+    uint32_t right = buildNode(mid, end, depth + 1, index);
+    nodes[index].first = right;
+    nodes[index].count = 0;
+    return index;
+}
+
+void Bvh::refit(std::span<const AABB> boxes)
+{
+    assert(boxes.size() == items.size());
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        leafBoxes[i] = boxes[items[i]];
+    }
+    // Children follow their parent, so a reverse pass sees them before it
+    for (auto i = nodes.size(); i-- > 0;)
+    {
+        refitNode(static_cast<uint32_t>(i));
+    }
+}
+
+void Bvh::refit(std::span<const uint32_t> moved, std::span<const AABB> boxes)
+{
+    assert(boxes.size() == items.size());
+    // Past a quarter of the items the paths cover most of the tree, and sorting them costs more than the full pass
+    if (moved.size() * 4 > items.size())
+    {
+        refit(boxes);
+        return;
+    }
+    for (auto item: moved)
+    {
+        auto slot = slots[item];
+        leafBoxes[slot] = boxes[item];
+        // Stop at the first listed node: the rest of the path to the root is listed too
+        for (auto node = leaves[slot]; node != noParent && !listed[node]; node = parents[node])
+        {
+            listed[node] = 1;
+            path.push_back(node);
+        }
+    }
+    // Children follow their parent, so a decreasing order refits them before it
+    std::sort(path.begin(), path.end(), std::greater<>());
+    for (auto node: path)
+    {
+        refitNode(node);
+        listed[node] = 0;
+    }
+    path.clear();
+}
+
+void Bvh::refitNode(uint32_t index)
+{
+    auto &node = nodes[index];
+    AABB box;
+    if (node.count > 0)
+    {
+        for (uint32_t i = node.first; i < node.first + node.count; ++i)
+        {
+            box.expand(leafBoxes[i]);
+        }
+    } else
+    {
+        box = nodes[index + 1].box;
+        box.expand(nodes[node.first].box);
+    }
+    node.box = box;
+}
@@ -0,0 +1,145 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_BVH_H
+#define CG_BVH_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "linear/Bounds.h"
+
+/**
+ * Bounding volume hierarchy over a set of boxes, stored as a flat array of nodes in depth-first order.
+ * Built top-down by splitting at the median of the longest axis of the centers; refit() updates the boxes of moving
+ * objects without changing the tree, either every node or only the paths from the moved items up to the root.
+ */
+class Bvh
+{
+public:
+    /**
+     * Items per leaf below which nodes are not split
+     */
+    static constexpr uint32_t leafSize = 4;
+
+    /**
+     * @param boxes bounds of the items, item i being boxes[i]
+     */
+    void build(std::span<const AABB> boxes);
+
+    /**
+     * Recompute the node boxes bottom-up for items that moved; the item count must be the one of build()
+     */
+    void refit(std::span<const AABB> boxes);
+
+    /**
+     * Recompute only the leaves of the moved items and their ancestors; the item count must be the one of build()
+     * @param moved ids of the items whose box changed, possibly with repeats
+     * @param boxes bounds of all the items
+     */
+    void refit(std::span<const uint32_t> moved, std::span<const AABB> boxes);
+
+    [[nodiscard]] inline bool empty() const
+    {
+        return nodes.empty();
+    }
+
+    [[nodiscard]] inline size_t itemCount() const
+    {
+        return items.size();
+    }
+
+    /**
+     * Visit the items whose box is at least partly inside the frustum. Subtrees outside are skipped whole, and
+     * subtrees fully inside are visited without any more tests.
+     * @param visit called as visit(item)
+     */
+    template<typename Visit>
+    void query(const Frustum &frustum, Visit &&visit) const
+    {
+        if (nodes.empty())
+        {
+            return;
+        }
+        uint32_t stack[64];
+        bool insideStack[64];
+        int top = 0;
+        stack[top] = 0;
+        insideStack[top++] = false;
+        while (top > 0)
+        {
+            --top;
+            uint32_t index = stack[top];
+            const auto &node = nodes[index];
+            bool inside = insideStack[top];
+            if (!inside)
+            {
+                auto t = frustum.test(node.box);
+                if (t == Frustum::Test::Outside)
+                {
+                    continue;
+                }
+                inside = t == Frustum::Test::Inside;
+            }
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    if (inside || frustum.test(leafBoxes[i]) != Frustum::Test::Outside)
+                    {
+                        visit(items[i]);
+                    }
+                }
+            } else
+            {
+                // The left child directly follows its parent
+                stack[top] = index + 1;
+                insideStack[top++] = inside;
+                stack[top] = node.first;
+                insideStack[top++] = inside;
+            }
+        }
+    }
+
+private:
+    struct Node
+    {
+        AABB box;
+        /**
+         * First item of a leaf, or the right child of an inner node
+         */
+        uint32_t first;
+        /**
+         * Items of a leaf, 0 for an inner node
+         */
+        uint32_t count;
+    };
+
+    static constexpr uint32_t noParent = ~uint32_t(0);
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> parents;
+    /**
+     * Item ids in leaf order, and their boxes in the same order
+     */
+    std::vector<uint32_t> items;
+    std::vector<AABB> leafBoxes;
+    /**
+     * Position of each item in leaf order, and the leaf holding each position
+     */
+    std::vector<uint32_t> slots;
+    std::vector<uint32_t> leaves;
+    std::vector<Vec3> centers;
+    /**
+     * Scratch of the partial refit: nodes on the paths of the moved items, and whether a node is already listed
+     */
+    std::vector<uint32_t> path;
+    std::vector<uint8_t> listed;
+
+    uint32_t buildNode(uint32_t begin, uint32_t end, int depth, uint32_t parent);
+
+    void refitNode(uint32_t index);
+};
+
+#endif //CG_BVH_H
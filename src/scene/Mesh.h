@@ -0,0 +1,50 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_MESH_H
+#define CG_MESH_H
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "linear/Vec.h"
+#include "tgaimage/tgaimage.h"
+
+/**
+ * Indexed triangle mesh in model space: every three indices form a triangle.
+ */
+struct Mesh
+{
+    std::vector<Vec3> positions;
+    std::vector<TGAColor> colors;
+    std::vector<uint32_t> indices;
+
+    /**
+     * @return index of the new vertex
+     */
+    inline uint32_t addVertex(const Vec3 &p, const TGAColor &c)
+    {
+        positions.push_back(p);
+        colors.push_back(c);
+        return static_cast<uint32_t>(positions.size() - 1);
+    }
+
+    inline void addTriangle(uint32_t i0, uint32_t i1, uint32_t i2)
+    {
+        assert(i0 < positions.size() && i1 < positions.size() && i2 < positions.size());
+        indices.insert(indices.end(), {i0, i1, i2});
+    }
+
+    [[nodiscard]] inline size_t vertexCount() const
+    {
+        return positions.size();
+    }
+
+    [[nodiscard]] inline size_t triangleCount() const
+    {
+        return indices.size() / 3;
+    }
+};
+
+#endif //CG_MESH_H
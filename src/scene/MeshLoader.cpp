@@ -0,0 +1,382 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MeshLoader.h"
+
+namespace
+{
+    /**
+     * Read-only memory mapping of a whole file
+     */
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const char *filename)
+        {
+            int fd = open(filename, O_RDONLY);
+            if (fd < 0)
+            {
+                return;
+            }
+            struct stat st{};
+            if (fstat(fd, &st) == 0)
+            {
+                // An empty file can't be mapped but is a valid, empty view
+                opened = st.st_size == 0;
+                if (st.st_size > 0)
+                {
+                    void *p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p != MAP_FAILED)
+                    {
+                        data = static_cast<const char *>(p);
+                        size = static_cast<size_t>(st.st_size);
+                        opened = true;
+                    }
+                }
+            }
+            close(fd);
+        }
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile()
+        {
+            if (data)
+            {
+                munmap(const_cast<char *>(data), size);
+            }
+        }
+
+        [[nodiscard]] inline bool isOpen() const
+        {
+            return opened;
+        }
+
+        [[nodiscard]] inline std::string_view view() const
+        {
+            return {data, size};
+        }
+
+    private:
+        const char *data = nullptr;
+        size_t size = 0;
+        bool opened = false;
+    };
+
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t vertexCount;
+        uint64_t indexCount;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        /**
+         * Bytes of a position coordinate, sizeof(Real) of the build that wrote the cache
+         */
+        uint32_t realSize;
+        uint32_t padding;
+    };
+
+    constexpr char cacheMagic[8] = {'C', 'G', 'M', 'E', 'S', 'H', 0, 0};
+    constexpr uint32_t cacheVersion = 2;
+
+    /**
+     * Cursor over the text of one OBJ file: no allocation, no locale, no iostreams
+     */
+    class Tokenizer
+    {
+    public:
+        explicit Tokenizer(std::string_view text) : p(text.data()), end(text.data() + text.size()) {}
+
+        [[nodiscard]] inline bool done() const
+        {
+            return p >= end;
+        }
+
+        inline void skipSpaces()
+        {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            {
+                ++p;
+            }
+        }
+
+        [[nodiscard]] inline bool atLineEnd()
+        {
+            skipSpaces();
+            return p >= end || *p == '\n' || *p == '#';
+        }
+
+        inline void nextLine()
+        {
+            auto nl = static_cast<const char *>(memchr(p, '\n', end - p));
+            p = nl ? nl + 1 : end;
+        }
+
+        /**
+         * Next run of non blank characters on the line
+         */
+        inline std::string_view word()
+        {
+            skipSpaces();
+            auto begin = p;
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+            {
+                ++p;
+            }
+            return {begin, static_cast<size_t>(p - begin)};
+        }
+
+        inline bool number(Real &out)
+        {
+            skipSpaces();
+            auto [next, ec] = std::from_chars(p, end, out);
+            if (ec != std::errc())
+            {
+                return false;
+            }
+            p = next;
+            return true;
+        }
+
+        /**
+         * Position index of a face vertex, skipping its texture and normal indices
+         */
+        inline bool faceIndex(long long &out)
+        {
+            skipSpaces();
+            auto [next, ec] = std::from_chars(p, end, out);
+            if (ec != std::errc())
+            {
+                return false;
+            }
+            p = next;
+            while (p < end && (*p == '/' || (*p >= '0' && *p <= '9') || *p == '-'))
+            {
+                ++p;
+            }
+            return true;
+        }
+
+    private:
+        const char *p;
+        const char *end;
+    };
+
+    inline unsigned char toChannel(Real v)
+    {
+        return static_cast<unsigned char>(std::clamp(v, Real(0), Real(1)) * 255 + Real(0.5));
+    }
+}
+
+bool parseObj(std::string_view text, Mesh &mesh)
+{
+    mesh = Mesh();
+    std::vector<Vec3> positions;
+    std::vector<TGAColor> colors;
+    // OBJ vertex -> mesh vertex, filled when a face first uses it
+    std::vector<uint32_t> remap;
+    std::vector<uint32_t> polygon;
+    constexpr auto unused = static_cast<uint32_t>(-1);
+    Tokenizer tok(text);
+    size_t line = 1;
+    for (; !tok.done(); tok.nextLine(), ++line)
+    {
+        auto keyword = tok.word();
+        if (keyword == "v")
+        {
+            Real x, y, z, r, g, b;
+            if (!tok.number(x) || !tok.number(y) || !tok.number(z))
+            {
+                std::cerr << "bad vertex at line " << line << "\n";
+                return false;
+            }
+            positions.push_back(Vec3{x, y, z});
+            if (!tok.atLineEnd() && tok.number(r) && tok.number(g) && tok.number(b))
+            {
+                colors.emplace_back(toChannel(r), toChannel(g), toChannel(b), 255);
+            } else
+            {
+                colors.emplace_back(255, 255, 255, 255);
+            }
+        } else if (keyword == "f")
+        {
+            remap.resize(positions.size(), unused);
+            polygon.clear();
+            while (!tok.atLineEnd())
+            {
+                long long index;
+                if (!tok.faceIndex(index))
+                {
+                    std::cerr << "bad face at line " << line << "\n";
+                    return false;
+                }
+                index = index < 0 ? static_cast<long long>(positions.size()) + index : index - 1;
+                if (index < 0 || index >= static_cast<long long>(positions.size()))
+                {
+                    std::cerr << "face index out of range at line " << line << "\n";
+                    return false;
+                }
+                auto &v = remap[index];
+                if (v == unused)
+                {
+                    v = mesh.addVertex(positions[index], colors[index]);
+                }
+                polygon.push_back(v);
+            }
+            for (size_t i = 2; i < polygon.size(); ++i)
+            {
+                mesh.indices.insert(mesh.indices.end(), {polygon[0], polygon[i - 1], polygon[i]});
+            }
+        }
+    }
+    return true;
+}
+
+bool loadObj(const char *filename, Mesh &mesh)
+{
+    MappedFile file(filename);
+    if (!file.isOpen())
+    {
+        std::cerr << "can't open file " << filename << "\n";
+        return false;
+    }
+    return parseObj(file.view(), mesh);
+}
+
+bool writeMeshCache(const char *filename, const Mesh &mesh, uint64_t sourceSize, int64_t sourceTime)
+{
+    CacheHeader header{};
+    memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.vertexCount = static_cast<uint32_t>(mesh.vertexCount());
+    header.indexCount = mesh.indices.size();
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.realSize = sizeof(Real);
+    std::vector<Real> positions;
+    positions.reserve(mesh.vertexCount() * 3);
+    for (auto &p: mesh.positions)
+    {
+        positions.insert(positions.end(), {p[0], p[1], p[2]});
+    }
+    std::vector<uint32_t> colors;
+    colors.reserve(mesh.vertexCount());
+    for (auto &c: mesh.colors)
+    {
+        colors.push_back(c.val);
+    }
+    // Written to a temporary name of its own then renamed, so a reader never maps a half written cache and
+    // processes writing the same cache at once each rename a whole one
+    auto tmp = std::string(filename) + ".XXXXXX";
+    int fd = mkstemp(tmp.data());
+    FILE *out = fd < 0 ? nullptr : fdopen(fd, "wb");
+    if (!out)
+    {
+        std::cerr << "can't open file " << tmp << "\n";
+        if (fd >= 0)
+        {
+            close(fd);
+            remove(tmp.c_str());
+        }
+        return false;
+    }
+    // mkstemp makes the file private to its owner
+    fchmod(fd, 0644);
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(positions.data(), sizeof(Real), positions.size(), out) == positions.size() &&
+              fwrite(colors.data(), sizeof(uint32_t), colors.size(), out) == colors.size() &&
+              fwrite(mesh.indices.data(), sizeof(uint32_t), mesh.indices.size(), out) == mesh.indices.size();
+    ok = fclose(out) == 0 && ok;
+    if (!ok || rename(tmp.c_str(), filename) != 0)
+    {
+        std::cerr << "can't write file " << filename << "\n";
+        remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool readMeshCache(const char *filename, Mesh &mesh, uint64_t sourceSize, int64_t sourceTime)
+{
+    MappedFile file(filename);
+    auto data = file.view();
+    CacheHeader header{};
+    if (data.size() < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    size_t expected = sizeof(header) + header.vertexCount * (3 * sizeof(Real) + sizeof(uint32_t)) +
+                      header.indexCount * sizeof(uint32_t);
+    // A cache of the other precision is parsed again, so positions never go through float in a double build
+    if (memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion ||
+        header.realSize != sizeof(Real) || header.sourceSize != sourceSize || header.sourceTime != sourceTime ||
+        data.size() != expected)
+    {
+        return false;
+    }
+    // The header keeps the positions aligned in the page aligned mapping, and the arrays after them 4-byte aligned
+    static_assert(sizeof(CacheHeader) % alignof(Real) == 0);
+    auto positions = reinterpret_cast<const Real *>(data.data() + sizeof(header));
+    auto colors = reinterpret_cast<const uint32_t *>(positions + 3 * header.vertexCount);
+    auto indices = colors + header.vertexCount;
+    mesh = Mesh();
+    mesh.positions.reserve(header.vertexCount);
+    mesh.colors.reserve(header.vertexCount);
+    for (uint32_t i = 0; i < header.vertexCount; ++i)
+    {
+        mesh.positions.push_back(Vec3{positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]});
+        mesh.colors.emplace_back(static_cast<int>(colors[i]), 4);
+    }
+    mesh.indices.assign(indices, indices + header.indexCount);
+    for (auto i: mesh.indices)
+    {
+        if (i >= header.vertexCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool loadMesh(const char *filename, Mesh &mesh)
+{
+    std::error_code ec;
+    auto size = std::filesystem::file_size(filename, ec);
+    if (ec)
+    {
+        std::cerr << "can't open file " << filename << "\n";
+        return false;
+    }
+    auto time = static_cast<int64_t>(std::filesystem::last_write_time(filename, ec).time_since_epoch().count());
+    auto cache = std::string(filename) + ".cgmesh";
+    if (readMeshCache(cache.c_str(), mesh, size, time))
+    {
+        return true;
+    }
+    if (!loadObj(filename, mesh))
+    {
+        return false;
+    }
+    // A cache that can't be written only costs the next load a parse
+    writeMeshCache(cache.c_str(), mesh, size, time);
+    return true;
+}
@@ -0,0 +1,46 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_MESHLOADER_H
+#define CG_MESHLOADER_H
+
+#include <cstdint>
+#include <string_view>
+#include "scene/Mesh.h"
+
+/**
+ * Parse Wavefront OBJ text into mesh, replacing its content.
+ * Only positions and faces are read: "v x y z [r g b]", with the common vertex color extension in [0, 1], and
+ * "f" with any of the v, v/vt, v//vn and v/vt/vn forms, negative indices counting back from the last vertex.
+ * Polygons are triangulated as fans. Each OBJ vertex referenced by a face becomes one mesh vertex, shared by every
+ * face using it; unreferenced vertices are dropped.
+ * @return false on a malformed line, reported on std::cerr
+ */
+bool parseObj(std::string_view text, Mesh &mesh);
+
+bool loadObj(const char *filename, Mesh &mesh);
+
+/**
+ * Write mesh as a binary cache: a header followed by the positions in Real, the colors and the indices, ready to
+ * be copied out of a memory mapping. The header records the size of Real, so a build of the other precision
+ * doesn't read the cache.
+ * @param sourceSize size of the file the mesh was loaded from, checked by readMeshCache
+ * @param sourceTime modification time of that file
+ */
+bool writeMeshCache(const char *filename, const Mesh &mesh, uint64_t sourceSize = 0, int64_t sourceTime = 0);
+
+/**
+ * Map a cache written by writeMeshCache and copy it into mesh
+ * @return false if the file is missing, malformed, written by a build of the other precision, or for another source
+ * size or time
+ */
+bool readMeshCache(const char *filename, Mesh &mesh, uint64_t sourceSize = 0, int64_t sourceTime = 0);
+
+/**
+ * Load an OBJ file through its cache, filename + ".cgmesh": the cache is used when it matches the size and
+ * modification time of the OBJ file, and is (re)written after parsing otherwise.
+ */
+bool loadMesh(const char *filename, Mesh &mesh);
+
+#endif //CG_MESHLOADER_H
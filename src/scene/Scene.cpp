@@ -0,0 +1,239 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <cassert>
+#include "Scene.h"
+#include "Simplify.h"
+#include "profile/Profiler.h"
+
+Scene::NodeId Scene::addNode(NodeId parent, const Affine3 &local, uint32_t mesh)
+{
+    assert(parent == none || parent < size());
+    assert(mesh == noMesh || mesh < meshes.size());
+    auto id = static_cast<NodeId>(size());
+    parents.push_back(parent);
+    firstChildren.push_back(none);
+    nextSiblings.push_back(none);
+    locals.push_back(local);
+    // Stale if an ancestor is dirty, in which case the ancestor's walk in update() reaches the new node too
+    worlds.push_back(parent == none ? local : worlds[parent] * local);
+    meshIds.push_back(mesh);
+    dirty.push_back(0);
+    occluders.push_back(0);
+    objectsChanged |= mesh != noMesh;
+    if (parent != none)
+    {
+        nextSiblings[id] = firstChildren[parent];
+        firstChildren[parent] = id;
+    }
+    return id;
+}
+
+uint32_t Scene::addMesh(Mesh mesh)
+{
+    meshBoxes.push_back(AABB::of(mesh.positions));
+    meshSpheres.push_back(Sphere::of(mesh.positions));
+    meshes.push_back(std::move(mesh));
+    meshLods.emplace_back();
+    return static_cast<uint32_t>(meshes.size() - 1);
+}
+
+void Scene::generateLods(uint32_t id, size_t minTriangles)
+{
+    meshLods[id] = buildLods(meshes[id], minTriangles);
+}
+
+void Scene::addLod(uint32_t id, Mesh level)
+{
+    assert(level.triangleCount() < getMesh(id, getLodCount(id) - 1).triangleCount());
+    meshLods[id].push_back(std::move(level));
+}
+
+void Scene::setMesh(NodeId node, uint32_t mesh)
+{
+    assert(mesh == noMesh || mesh < meshes.size());
+    objectsChanged |= meshIds[node] != mesh;
+    meshIds[node] = mesh;
+}
+
+void Scene::setLocal(NodeId node, const Affine3 &local)
+{
+    locals[node] = local;
+    if (!dirty[node])
+    {
+        dirty[node] = 1;
+        dirtyNodes.push_back(node);
+    }
+}
+
+size_t Scene::update()
+{
+    // Ancestors have smaller ids: handling the nodes in order recomputes a subtree once, from its topmost dirty node
+    std::sort(dirtyNodes.begin(), dirtyNodes.end());
+    size_t count = 0;
+    for (auto root: dirtyNodes)
+    {
+        if (!dirty[root])
+        {
+            continue;
+        }
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            auto node = stack.back();
+            stack.pop_back();
+            auto parent = parents[node];
+            worlds[node] = parent == none ? locals[node] : worlds[parent] * locals[node];
+            dirty[node] = 0;
+            if (meshIds[node] != noMesh)
+            {
+                movedNodes.push_back(node);
+            }
+            ++count;
+            for (auto child = firstChildren[node]; child != none; child = nextSiblings[child])
+            {
+                stack.push_back(child);
+            }
+        }
+    }
+    dirtyNodes.clear();
+    // Updates without a draw in between repeat the nodes that keep moving: keep the list within the node count
+    if (movedNodes.size() > size())
+    {
+        std::sort(movedNodes.begin(), movedNodes.end());
+        movedNodes.erase(std::unique(movedNodes.begin(), movedNodes.end()), movedNodes.end());
+    }
+    return count;
+}
+
+void Scene::updateBvh()
+{
+    if (objectsChanged)
+    {
+        objects.clear();
+        objectIndices.resize(size());
+        for (NodeId node = 0; node < size(); ++node)
+        {
+            if (meshIds[node] != noMesh)
+            {
+                objectIndices[node] = static_cast<uint32_t>(objects.size());
+                objects.push_back(node);
+            }
+        }
+        objectBoxes.resize(objects.size());
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            objectBoxes[i] = meshBoxes[meshIds[objects[i]]].transformed(worlds[objects[i]]);
+        }
+        bvh.build(objectBoxes);
+    } else if (!movedNodes.empty())
+    {
+        for (auto node: movedNodes)
+        {
+            auto i = objectIndices[node];
+            objectBoxes[i] = meshBoxes[meshIds[node]].transformed(worlds[node]);
+            movedObjects.push_back(i);
+        }
+        bvh.refit(movedObjects, objectBoxes);
+        movedObjects.clear();
+    }
+    objectsChanged = false;
+    movedNodes.clear();
+}
+
+void Scene::cullOccluded(const Image &img)
+{
+    occlusion.begin(img.getClipTransform(), img.getWSign());
+    for (auto item: visible)
+    {
+        auto node = objects[item];
+        if (!occluders[node])
+        {
+            continue;
+        }
+        const auto &mesh = meshes[meshIds[node]];
+        const auto &world = worlds[node];
+        occluderPositions.clear();
+        for (auto &p: mesh.positions)
+        {
+            occluderPositions.push_back(world.apply(p));
+        }
+        occlusion.addOccluder(occluderPositions, mesh.indices);
+    }
+    // Occluders are kept: they are behind nothing of their own
+    std::erase_if(visible, [this](uint32_t item)
+    {
+        return !occluders[objects[item]] && occlusion.isOccluded(objectBoxes[item]);
+    });
+}
+
+size_t Scene::selectLod(NodeId node, const Image &img, int width, int height) const
+{
+    auto id = meshIds[node];
+    if (meshLods[id].empty())
+    {
+        return 0;
+    }
+    auto sphere = meshSpheres[id].transformed(worlds[node]);
+    const auto &m = img.getClipTransform();
+    const auto &c = sphere.center;
+    Real w = (m[3][0] * c[0] + m[3][1] * c[1] + m[3][2] * c[2] + m[3][3]) * img.getWSign();
+    if (w <= sphere.radius)
+    {
+        // The camera is in or right next to the sphere
+        return 0;
+    }
+    // Pixels per world unit at distance w, from the rows producing x and y
+    Real sx = std::sqrt(m[0][0] * m[0][0] + m[0][1] * m[0][1] + m[0][2] * m[0][2]) * static_cast<Real>(width) / 2;
+    Real sy = std::sqrt(m[1][0] * m[1][0] + m[1][1] * m[1][1] + m[1][2] * m[1][2]) * static_cast<Real>(height) / 2;
+    Real radius = sphere.radius * std::max(sx, sy) / w;
+    Real budget = lodDensity * Real(3.14159265) * radius * radius;
+    size_t level = 0;
+    while (level + 1 < getLodCount(id) && static_cast<Real>(getMesh(id, level).triangleCount()) > budget)
+    {
+        ++level;
+    }
+    return level;
+}
+
+size_t Scene::draw(Image &img)
+{
+    {
+        CG_PROFILE_SCOPE("scene update");
+        update();
+        updateBvh();
+    }
+    {
+        CG_PROFILE_SCOPE("frustum cull");
+        visible.clear();
+        bvh.query(img.getFrustum(), [this](uint32_t item) { visible.push_back(item); });
+        // Forward shading has no depth test: keep the order of the nodes whatever the order of the BVH. Objects
+        // are listed in node order, so sorting their indices sorts the nodes.
+        std::sort(visible.begin(), visible.end());
+    }
+    if (occlusionCulling && img.getShadingMode() == Image::ShadingMode::Deferred)
+    {
+        CG_PROFILE_SCOPE("occlusion cull");
+        cullOccluded(img);
+    }
+    CG_PROFILE_SCOPE("scene triangles");
+    triangles.clear();
+    int width = img.get_width(), height = img.get_height();
+    for (auto item: visible)
+    {
+        auto node = objects[item];
+        const auto &mesh = getMesh(meshIds[node], selectLod(node, img, width, height));
+        const auto &world = worlds[node];
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            auto i0 = mesh.indices[i], i1 = mesh.indices[i + 1], i2 = mesh.indices[i + 2];
+            triangles.emplace_back(Point(world.apply(mesh.positions[i0]), mesh.colors[i0]),
+                                   Point(world.apply(mesh.positions[i1]), mesh.colors[i1]),
+                                   Point(world.apply(mesh.positions[i2]), mesh.colors[i2]));
+        }
+    }
+    img.drawTriangles(triangles);
+    return visible.size();
+}
@@ -0,0 +1,249 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_SCENE_H
+#define CG_SCENE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "linear/Affine.h"
+#include "linear/Bounds.h"
+#include "render/Image.h"
+#include "render/OcclusionBuffer.h"
+#include "scene/Bvh.h"
+#include "scene/Mesh.h"
+
+/**
+ * Transform hierarchy of nodes, each with a local transform relative to its parent and optionally a mesh.
+ * Nodes live in flat parallel arrays indexed by node id; a parent always has a smaller id than its children.
+ * Changing a local transform only marks the node dirty: update() recomputes the world transforms of the dirty
+ * subtrees and nothing else, so the cost follows what moved, not the size of the scene.
+ * Nodes with a mesh are kept in a BVH of their world bounds, so draw() rejects whole groups of objects outside the
+ * view frustum before transforming any vertex.
+ * With occlusion culling on, nodes flagged as occluders are first rasterized into a coarse depth buffer and the
+ * other visible nodes are skipped when their bounds are hidden behind them. Culling only applies to deferred frames:
+ * forward shading draws in node order without a depth test, where skipping a hidden node would change the image.
+ * Meshes can have simplified levels of detail, picked per node so the triangle count follows the screen area.
+ */
+class Scene
+{
+public:
+    typedef uint32_t NodeId;
+
+    static constexpr NodeId none = std::numeric_limits<NodeId>::max();
+
+    static constexpr uint32_t noMesh = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @param parent none for a root
+     * @param local transform relative to the parent
+     * @param mesh id returned by addMesh, or noMesh
+     * @return id of the new node
+     */
+    NodeId addNode(NodeId parent = none, const Affine3 &local = {}, uint32_t mesh = noMesh);
+
+    /**
+     * @return id to attach the mesh to nodes with
+     */
+    uint32_t addMesh(Mesh mesh);
+
+    [[nodiscard]] inline const Mesh &getMesh(uint32_t id) const
+    {
+        return meshes[id];
+    }
+
+    /**
+     * Simplified levels of detail of a mesh, each with about half the triangles of the previous one
+     * @param id
+     * @param minTriangles size under which no more level is made
+     */
+    void generateLods(uint32_t id, size_t minTriangles = 32);
+
+    /**
+     * Append a level made offline, with fewer triangles than the last one
+     */
+    void addLod(uint32_t id, Mesh level);
+
+    /**
+     * Number of levels, the mesh itself being level 0
+     */
+    [[nodiscard]] inline size_t getLodCount(uint32_t id) const
+    {
+        return meshLods[id].size() + 1;
+    }
+
+    [[nodiscard]] inline const Mesh &getMesh(uint32_t id, size_t level) const
+    {
+        return level == 0 ? meshes[id] : meshLods[id][level - 1];
+    }
+
+    /**
+     * Triangles per covered pixel aimed at when selecting levels: draw() takes the first level with at most that
+     * many triangles per pixel of the projected bounding sphere
+     * @param trianglesPerPixel
+     */
+    inline void setLodDensity(Real trianglesPerPixel)
+    {
+        lodDensity = trianglesPerPixel;
+    }
+
+    /**
+     * Bounds of a mesh in model space
+     */
+    [[nodiscard]] inline const AABB &getMeshBox(uint32_t id) const
+    {
+        return meshBoxes[id];
+    }
+
+    [[nodiscard]] inline const Sphere &getMeshSphere(uint32_t id) const
+    {
+        return meshSpheres[id];
+    }
+
+    void setLocal(NodeId node, const Affine3 &local);
+
+    inline void setLocal(NodeId node, const Mat4 &local)
+    {
+        setLocal(node, Affine3(local));
+    }
+
+    [[nodiscard]] inline const Affine3 &getLocal(NodeId node) const
+    {
+        return locals[node];
+    }
+
+    /**
+     * Transform from the node to the world, as of the last update()
+     */
+    [[nodiscard]] inline const Affine3 &getWorld(NodeId node) const
+    {
+        return worlds[node];
+    }
+
+    [[nodiscard]] inline NodeId getParent(NodeId node) const
+    {
+        return parents[node];
+    }
+
+    void setMesh(NodeId node, uint32_t mesh);
+
+    [[nodiscard]] inline uint32_t getMeshId(NodeId node) const
+    {
+        return meshIds[node];
+    }
+
+    /**
+     * Flag a node whose mesh is large and solid enough to hide others, e.g. walls and terrain
+     */
+    inline void setOccluder(NodeId node, bool occluder)
+    {
+        occluders[node] = occluder;
+    }
+
+    [[nodiscard]] inline bool isOccluder(NodeId node) const
+    {
+        return occluders[node] != 0;
+    }
+
+    /**
+     * Only applied when drawing in the deferred mode: forward shading has no depth test, so a hidden node drawn
+     * later would still show
+     * @param enable
+     */
+    inline void setOcclusionCulling(bool enable)
+    {
+        occlusionCulling = enable;
+    }
+
+    [[nodiscard]] inline const OcclusionBuffer &getOcclusionBuffer() const
+    {
+        return occlusion;
+    }
+
+    [[nodiscard]] inline size_t size() const
+    {
+        return parents.size();
+    }
+
+    /**
+     * Recompute the world transform of every dirty node and of its descendants
+     * @return number of world transforms recomputed
+     */
+    size_t update();
+
+    /**
+     * Update, then draw the triangles of every node with a mesh whose world bounds intersect the view frustum of
+     * img, transformed to the world, in node order
+     * @param img
+     * @return number of nodes drawn
+     */
+    size_t draw(Image &img);
+
+private:
+    std::vector<NodeId> parents;
+    std::vector<NodeId> firstChildren;
+    std::vector<NodeId> nextSiblings;
+    std::vector<Affine3> locals;
+    std::vector<Affine3> worlds;
+    std::vector<uint32_t> meshIds;
+    std::vector<uint8_t> dirty;
+    std::vector<uint8_t> occluders;
+    /**
+     * Nodes whose local transform changed since the last update, possibly with repeats
+     */
+    std::vector<NodeId> dirtyNodes;
+    std::vector<Mesh> meshes;
+    std::vector<std::vector<Mesh>> meshLods;
+    std::vector<AABB> meshBoxes;
+    std::vector<Sphere> meshSpheres;
+    /**
+     * Nodes with a mesh, the items of the BVH, with their world boxes
+     */
+    std::vector<NodeId> objects;
+    std::vector<AABB> objectBoxes;
+    /**
+     * Object index of each node with a mesh, valid while the set of objects doesn't change
+     */
+    std::vector<uint32_t> objectIndices;
+    Bvh bvh;
+    /**
+     * The set of objects changed: the BVH is rebuilt. Otherwise only the moved objects are refit, with their ancestors
+     * in the BVH.
+     */
+    bool objectsChanged = false;
+    /**
+     * Nodes with a mesh whose world transform changed since the last draw, possibly with repeats, then their object
+     * indices
+     */
+    std::vector<NodeId> movedNodes;
+    std::vector<uint32_t> movedObjects;
+    bool occlusionCulling = false;
+    Real lodDensity = Real(0.5);
+    OcclusionBuffer occlusion;
+    /**
+     * Scratch of draw(), kept to reuse its capacity
+     */
+    std::vector<Triangle> triangles;
+    std::vector<Vec3> occluderPositions;
+    std::vector<NodeId> stack;
+    /**
+     * Object indices that pass the frustum test, then the ones that are drawn
+     */
+    std::vector<uint32_t> visible;
+
+    void updateBvh();
+
+    /**
+     * Rasterize the visible occluders, then drop the visible objects they hide
+     */
+    void cullOccluded(const Image &img);
+
+    /**
+     * Level of a node from the area its bounding sphere covers on screen
+     */
+    [[nodiscard]] size_t selectLod(NodeId node, const Image &img, int width, int height) const;
+};
+
+#endif //CG_SCENE_H
@@ -0,0 +1,611 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include "Simplify.h"
+
+namespace
+{
+    typedef std::array<double, 3> Point3;
+
+    inline Point3 sub(const Point3 &a, const Point3 &b)
+    {
+        return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+    }
+
+    inline Point3 cross(const Point3 &a, const Point3 &b)
+    {
+        return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+    }
+
+    inline double dot(const Point3 &a, const Point3 &b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    /**
+     * Symmetric 4x4 matrix of the summed squared distances to a set of planes, upper triangle only
+     */
+    struct Quadric
+    {
+        double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+        /**
+         * Plane ax + by + cz + d = 0 with a unit normal, weighted
+         */
+        static Quadric plane(const Point3 &n, double d, double weight)
+        {
+            return {weight * n[0] * n[0], weight * n[0] * n[1], weight * n[0] * n[2], weight * n[0] * d,
+                    weight * n[1] * n[1], weight * n[1] * n[2], weight * n[1] * d,
+                    weight * n[2] * n[2], weight * n[2] * d, weight * d * d};
+        }
+
+        Quadric &operator+=(const Quadric &o)
+        {
+            a2 += o.a2, ab += o.ab, ac += o.ac, ad += o.ad, b2 += o.b2;
+            bc += o.bc, bd += o.bd, c2 += o.c2, cd += o.cd, d2 += o.d2;
+            return *this;
+        }
+
+        [[nodiscard]] double error(const Point3 &p) const
+        {
+            double x = p[0], y = p[1], z = p[2];
+            return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x + b2 * y * y + 2 * bc * y * z +
+                   2 * bd * y + c2 * z * z + 2 * cd * z + d2;
+        }
+
+        /**
+         * Point minimizing the error, by Cramer's rule on the 3x3 part
+         * @return false if the system is singular
+         */
+        bool minimum(Point3 &p) const
+        {
+            double det = a2 * (b2 * c2 - bc * bc) - ab * (ab * c2 - bc * ac) + ac * (ab * bc - b2 * ac);
+            double scale = std::abs(a2) + std::abs(b2) + std::abs(c2);
+            if (std::abs(det) <= 1e-12 * scale * scale * scale)
+            {
+                return false;
+            }
+            double inv = 1 / det;
+            p[0] = -inv * (ad * (b2 * c2 - bc * bc) - ab * (bd * c2 - bc * cd) + ac * (bd * bc - b2 * cd));
+            p[1] = -inv * (a2 * (bd * c2 - cd * bc) - ad * (ab * c2 - bc * ac) + ac * (ab * cd - bd * ac));
+            p[2] = -inv * (a2 * (b2 * cd - bc * bd) - ab * (ab * cd - bd * ac) + ad * (ab * bc - b2 * ac));
+            return true;
+        }
+    };
+
+    struct Candidate
+    {
+        double cost;
+        uint32_t u, v;
+        uint32_t versionU, versionV;
+        Point3 target;
+
+        /**
+         * Ties, common on symmetric meshes, go to the edge of lower vertex ids, so the order doesn't depend on the heap
+         */
+        bool operator>(const Candidate &o) const
+        {
+            return std::tie(cost, u, v) > std::tie(o.cost, o.u, o.v);
+        }
+    };
+
+    class Simplifier
+    {
+    public:
+        explicit Simplifier(const Mesh &mesh)
+        {
+            size_t n = mesh.vertexCount();
+            positions.resize(n);
+            colors.resize(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                positions[i] = {mesh.positions[i][0], mesh.positions[i][1], mesh.positions[i][2]};
+                colors[i] = {static_cast<double>(mesh.colors[i].r), static_cast<double>(mesh.colors[i].g),
+                             static_cast<double>(mesh.colors[i].b), static_cast<double>(mesh.colors[i].a)};
+            }
+            Point3 lo = positions.empty() ? Point3{} : positions[0], hi = lo;
+            for (auto &p: positions)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    lo[i] = std::min(lo[i], p[i]);
+                    hi[i] = std::max(hi[i], p[i]);
+                }
+            }
+            double diagonal = std::sqrt(dot(sub(hi, lo), sub(hi, lo)));
+            epsilon = relativeEpsilon * diagonal;
+            auto welded = weld(lo);
+            quadrics.resize(n);
+            versions.resize(n, 0);
+            alive.resize(n, 1);
+            adjacency.resize(n);
+            for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+            {
+                std::array<uint32_t, 3> tri{welded[mesh.indices[t]], welded[mesh.indices[t + 1]],
+                                            welded[mesh.indices[t + 2]]};
+                if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0])
+                {
+                    continue;
+                }
+                auto id = static_cast<uint32_t>(triangles.size());
+                triangles.push_back(tri);
+                triangleAlive.push_back(1);
+                for (auto v: tri)
+                {
+                    adjacency[v].push_back(id);
+                }
+            }
+            liveTriangles = triangles.size();
+            initQuadrics();
+            initCandidates();
+        }
+
+        void run(size_t target)
+        {
+            while (liveTriangles > target && !heap.empty())
+            {
+                auto c = heap.top();
+                heap.pop();
+                if (!alive[c.u] || !alive[c.v] || versions[c.u] != c.versionU || versions[c.v] != c.versionV)
+                {
+                    continue;
+                }
+                collapse(c);
+            }
+        }
+
+        [[nodiscard]] Mesh result() const
+        {
+            Mesh ret;
+            std::vector<uint32_t> remap(positions.size(), unused);
+            for (size_t t = 0; t < triangles.size(); ++t)
+            {
+                if (!triangleAlive[t])
+                {
+                    continue;
+                }
+                for (auto v: triangles[t])
+                {
+                    if (remap[v] == unused)
+                    {
+                        const auto &p = positions[v];
+                        const auto &c = colors[v];
+                        remap[v] = ret.addVertex(Vec3{static_cast<Real>(p[0]), static_cast<Real>(p[1]),
+                                                      static_cast<Real>(p[2])},
+                                                 TGAColor(channel(c[0]), channel(c[1]), channel(c[2]),
+                                                          channel(c[3])));
+                    }
+                    ret.indices.push_back(remap[v]);
+                }
+            }
+            return ret;
+        }
+
+    private:
+        static constexpr uint32_t unused = static_cast<uint32_t>(-1);
+        /**
+         * Weight of the planes holding borders in place, relative to the area weighted face planes
+         */
+        static constexpr double borderWeight = 1000;
+        /**
+         * Distance under which positions are taken as equal, relative to the diagonal of the mesh: far above the
+         * rounding of float positions, far below any detail worth keeping
+         */
+        static constexpr double relativeEpsilon = 1e-5;
+
+        double epsilon = 0;
+
+        std::vector<Point3> positions;
+        std::vector<std::array<double, 4>> colors;
+        std::vector<Quadric> quadrics;
+        std::vector<uint32_t> versions;
+        std::vector<uint8_t> alive;
+        std::vector<std::vector<uint32_t>> adjacency;
+        std::vector<std::array<uint32_t, 3>> triangles;
+        std::vector<uint8_t> triangleAlive;
+        size_t liveTriangles = 0;
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> heap;
+
+        /**
+         * Map every vertex to the first one within epsilon of it. Meshes split vertices where colors or texture
+         * coordinates are discontinuous, as along the seam of a sphere, and these splits would otherwise be taken
+         * for borders and kept while the rest of the surface collapses; the merged vertex keeps the first color.
+         * The split copies are often computed differently, so they are only equal up to rounding.
+         * Vertices are hashed into cells about the size of epsilon, so only the vertices of the 27 cells around a vertex are
+         * compared with it, whatever coordinates they share with the rest of the mesh.
+         * @param lo minimum corner of the bounds of the positions
+         */
+        [[nodiscard]] std::vector<uint32_t> weld(const Point3 &lo) const
+        {
+            constexpr uint32_t none = ~uint32_t(0);
+            constexpr int cellBits = 21;
+            std::vector<uint32_t> welded(positions.size()), next(positions.size());
+            // Cells twice as wide as epsilon keep vertices within epsilon in neighbouring cells despite rounding. A
+            // mesh reduced to one point has no extent to scale epsilon, and all its vertices share one cell.
+            double cell = epsilon > 0 ? 2 * epsilon : 1;
+            auto cellOf = [&](const Point3 &p)
+            {
+                std::array<int64_t, 3> c{};
+                for (int i = 0; i < 3; ++i)
+                {
+                    // At most 1 / relativeEpsilon cells per axis, as the extent is at most the diagonal
+                    c[i] = static_cast<int64_t>((p[i] - lo[i]) / cell);
+                    assert(c[i] >= 0 && c[i] < (int64_t(1) << cellBits));
+                }
+                return c;
+            };
+            auto key = [](const std::array<int64_t, 3> &c)
+            {
+                return static_cast<uint64_t>(c[0]) << 2 * cellBits | static_cast<uint64_t>(c[1]) << cellBits |
+                       static_cast<uint64_t>(c[2]);
+            };
+            // Vertices of a cell as a list through next, from the last one added
+            std::unordered_map<uint64_t, uint32_t> cells;
+            cells.reserve(positions.size());
+            for (uint32_t i = 0; i < positions.size(); ++i)
+            {
+                welded[i] = i;
+                auto [it, added] = cells.try_emplace(key(cellOf(positions[i])), none);
+                next[i] = it->second;
+                it->second = i;
+            }
+            // Groups merged as a union-find whose root is the first vertex of the group
+            auto root = [&welded](uint32_t v)
+            {
+                while (welded[v] != v)
+                {
+                    v = welded[v] = welded[welded[v]];
+                }
+                return v;
+            };
+            for (uint32_t i = 0; i < positions.size(); ++i)
+            {
+                const auto &p = positions[i];
+                auto c = cellOf(p);
+                for (int64_t dx = -1; dx <= 1; ++dx)
+                {
+                    for (int64_t dy = -1; dy <= 1; ++dy)
+                    {
+                        for (int64_t dz = -1; dz <= 1; ++dz)
+                        {
+                            std::array<int64_t, 3> n{c[0] + dx, c[1] + dy, c[2] + dz};
+                            if (n[0] < 0 || n[1] < 0 || n[2] < 0)
+                            {
+                                continue;
+                            }
+                            auto it = cells.find(key(n));
+                            if (it == cells.end())
+                            {
+                                continue;
+                            }
+                            // Each pair once, from its larger id
+                            for (auto j = it->second; j != none; j = next[j])
+                            {
+                                const auto &q = positions[j];
+                                if (j < i && std::abs(p[0] - q[0]) <= epsilon && std::abs(p[1] - q[1]) <= epsilon &&
+                                    std::abs(p[2] - q[2]) <= epsilon)
+                                {
+                                    auto a = root(i), b = root(j);
+                                    welded[std::max(a, b)] = std::min(a, b);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            for (uint32_t i = 0; i < welded.size(); ++i)
+            {
+                welded[i] = root(i);
+            }
+            return welded;
+        }
+
+        static inline unsigned char channel(double c)
+        {
+            return static_cast<unsigned char>(std::clamp(std::lround(c), 0L, 255L));
+        }
+
+        void initQuadrics()
+        {
+            // Edges as (min, max, opposite) to find the border edges, used by exactly one triangle
+            std::vector<std::array<uint32_t, 3>> edges;
+            for (auto &tri: triangles)
+            {
+                auto n = cross(sub(positions[tri[1]], positions[tri[0]]), sub(positions[tri[2]], positions[tri[0]]));
+                double len = std::sqrt(dot(n, n));
+                if (len == 0)
+                {
+                    continue;
+                }
+                Point3 unit{n[0] / len, n[1] / len, n[2] / len};
+                auto q = Quadric::plane(unit, -dot(unit, positions[tri[0]]), len / 2);
+                for (int i = 0; i < 3; ++i)
+                {
+                    quadrics[tri[i]] += q;
+                    uint32_t a = tri[i], b = tri[(i + 1) % 3];
+                    edges.push_back({std::min(a, b), std::max(a, b), tri[(i + 2) % 3]});
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            for (size_t i = 0; i < edges.size();)
+            {
+                size_t j = i + 1;
+                while (j < edges.size() && edges[j][0] == edges[i][0] && edges[j][1] == edges[i][1])
+                {
+                    ++j;
+                }
+                if (j - i == 1)
+                {
+                    addBorderPlane(edges[i][0], edges[i][1], edges[i][2]);
+                }
+                i = j;
+            }
+        }
+
+        /**
+         * Plane through the border edge (a, b), perpendicular to its triangle
+         */
+        void addBorderPlane(uint32_t a, uint32_t b, uint32_t opposite)
+        {
+            auto e = sub(positions[b], positions[a]);
+            auto n = cross(e, cross(e, sub(positions[opposite], positions[a])));
+            double len = std::sqrt(dot(n, n));
+            if (len == 0)
+            {
+                return;
+            }
+            Point3 unit{n[0] / len, n[1] / len, n[2] / len};
+            auto q = Quadric::plane(unit, -dot(unit, positions[a]), borderWeight * dot(e, e));
+            quadrics[a] += q;
+            quadrics[b] += q;
+        }
+
+        void initCandidates()
+        {
+            std::vector<std::pair<uint32_t, uint32_t>> edges;
+            for (auto &tri: triangles)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    edges.emplace_back(std::min(tri[i], tri[(i + 1) % 3]), std::max(tri[i], tri[(i + 1) % 3]));
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            for (auto [u, v]: edges)
+            {
+                push(u, v);
+            }
+        }
+
+        void push(uint32_t u, uint32_t v)
+        {
+            Quadric q = quadrics[u];
+            q += quadrics[v];
+            const auto &pu = positions[u], &pv = positions[v];
+            Point3 best{};
+            double cost;
+            Point3 opt;
+            // The optimum is only taken within the box of the edge, so vertices never leave the original bounds. An
+            // optimum on a face of the box, as on a symmetric mesh, is only there up to rounding.
+            bool inside = q.minimum(opt);
+            for (int i = 0; inside && i < 3; ++i)
+            {
+                double lo = std::min(pu[i], pv[i]), hi = std::max(pu[i], pv[i]);
+                inside = opt[i] >= lo - epsilon && opt[i] <= hi + epsilon;
+                opt[i] = std::clamp(opt[i], lo, hi);
+            }
+            if (inside)
+            {
+                best = opt;
+                cost = q.error(opt);
+            } else
+            {
+                Point3 mid{(pu[0] + pv[0]) / 2, (pu[1] + pv[1]) / 2, (pu[2] + pv[2]) / 2};
+                best = pu;
+                cost = q.error(pu);
+                for (auto &p: {pv, mid})
+                {
+                    double e = q.error(p);
+                    if (e < cost)
+                    {
+                        cost = e;
+                        best = p;
+                    }
+                }
+            }
+            heap.push({cost, u, v, versions[u], versions[v], best});
+        }
+
+        /**
+         * @return true if moving vertex from to p flips or flattens one of its triangles that doesn't contain other
+         */
+        bool foldsOver(uint32_t from, uint32_t other, const Point3 &p) const
+        {
+            for (auto t: adjacency[from])
+            {
+                if (!triangleAlive[t])
+                {
+                    continue;
+                }
+                const auto &tri = triangles[t];
+                if (tri[0] == other || tri[1] == other || tri[2] == other)
+                {
+                    continue;
+                }
+                std::array<Point3, 3> before{positions[tri[0]], positions[tri[1]], positions[tri[2]]};
+                auto after = before;
+                for (int i = 0; i < 3; ++i)
+                {
+                    if (tri[i] == from)
+                    {
+                        after[i] = p;
+                    }
+                }
+                auto n0 = cross(sub(before[1], before[0]), sub(before[2], before[0]));
+                auto n1 = cross(sub(after[1], after[0]), sub(after[2], after[0]));
+                if (dot(n0, n1) <= 0.1 * std::sqrt(dot(n0, n0) * dot(n1, n1)))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Vertices sharing a live triangle with v, sorted
+         */
+        [[nodiscard]] std::vector<uint32_t> ring(uint32_t v) const
+        {
+            std::vector<uint32_t> ret;
+            for (auto t: adjacency[v])
+            {
+                if (triangleAlive[t])
+                {
+                    for (auto w: triangles[t])
+                    {
+                        if (w != v)
+                        {
+                            ret.push_back(w);
+                        }
+                    }
+                }
+            }
+            std::sort(ret.begin(), ret.end());
+            ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+            return ret;
+        }
+
+        /**
+         * Link condition: the only vertices adjacent to both u and v are those of the triangles on the edge.
+         * Otherwise the collapse pinches the surface, leaving duplicated triangles and fins that fold it flat.
+         */
+        [[nodiscard]] bool keepsManifold(uint32_t u, uint32_t v) const
+        {
+            auto ru = ring(u), rv = ring(v);
+            std::vector<uint32_t> shared;
+            std::set_intersection(ru.begin(), ru.end(), rv.begin(), rv.end(), std::back_inserter(shared));
+            size_t opposite = 0;
+            for (auto t: adjacency[u])
+            {
+                const auto &tri = triangles[t];
+                if (triangleAlive[t] && (tri[0] == v || tri[1] == v || tri[2] == v))
+                {
+                    ++opposite;
+                }
+            }
+            return shared.size() == opposite;
+        }
+
+        void collapse(const Candidate &c)
+        {
+            uint32_t u = c.u, v = c.v;
+            if (!keepsManifold(u, v) || foldsOver(u, v, c.target) || foldsOver(v, u, c.target))
+            {
+                return;
+            }
+            auto e = sub(positions[v], positions[u]);
+            double len2 = dot(e, e), t = len2 > 0 ? std::clamp(dot(sub(c.target, positions[u]), e) / len2, 0., 1.) : 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                colors[u][i] += t * (colors[v][i] - colors[u][i]);
+            }
+            positions[u] = c.target;
+            quadrics[u] += quadrics[v];
+            alive[v] = 0;
+            ++versions[u];
+            for (auto tri: adjacency[v])
+            {
+                if (!triangleAlive[tri])
+                {
+                    continue;
+                }
+                auto &verts = triangles[tri];
+                if (verts[0] == u || verts[1] == u || verts[2] == u)
+                {
+                    triangleAlive[tri] = 0;
+                    --liveTriangles;
+                    continue;
+                }
+                std::replace(verts.begin(), verts.end(), v, u);
+                adjacency[u].push_back(tri);
+            }
+            adjacency[v].clear();
+            std::erase_if(adjacency[u], [this](uint32_t tri) { return !triangleAlive[tri]; });
+            std::vector<uint32_t> neighbours;
+            for (auto tri: adjacency[u])
+            {
+                for (auto w: triangles[tri])
+                {
+                    if (w != u)
+                    {
+                        neighbours.push_back(w);
+                    }
+                }
+            }
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+            for (auto w: neighbours)
+            {
+                ++versions[w];
+            }
+            // Bumping the neighbours' versions dropped all their candidates, so every edge around them is pushed again
+            std::vector<std::pair<uint32_t, uint32_t>> edges;
+            for (auto w: neighbours)
+            {
+                for (auto tri: adjacency[w])
+                {
+                    for (auto x: triangles[tri])
+                    {
+                        if (x != w)
+                        {
+                            edges.emplace_back(std::min(w, x), std::max(w, x));
+                        }
+                    }
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            for (auto [a, b]: edges)
+            {
+                push(a, b);
+            }
+        }
+    };
+}
+
+Mesh simplifyMesh(const Mesh &mesh, size_t targetTriangles)
+{
+    Simplifier simplifier(mesh);
+    simplifier.run(targetTriangles);
+    return simplifier.result();
+}
+
+std::vector<Mesh> buildLods(const Mesh &mesh, size_t minTriangles, double ratio)
+{
+    std::vector<Mesh> lods;
+    const Mesh *previous = &mesh;
+    while (previous->triangleCount() > minTriangles)
+    {
+        auto target = std::max(minTriangles, static_cast<size_t>(static_cast<double>(previous->triangleCount()) * ratio));
+        auto next = simplifyMesh(*previous, target);
+        if (next.triangleCount() >= previous->triangleCount())
+        {
+            break;
+        }
+        lods.push_back(std::move(next));
+        previous = &lods.back();
+    }
+    return lods;
+}
@@ -0,0 +1,29 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_SIMPLIFY_H
+#define CG_SIMPLIFY_H
+
+#include <cstddef>
+#include <vector>
+#include "scene/Mesh.h"
+
+/**
+ * Reduce mesh to about targetTriangles triangles by collapsing edges in order of their quadric error (Garland and
+ * Heckbert). Mesh borders are kept with extra quadrics along border edges, collapses that would fold a triangle
+ * over are refused, and every new vertex stays within the box of the edge it replaces, so the result never leaves
+ * the bounds of the original mesh. Colors are interpolated along the collapsed edges.
+ * Positions are welded within a tolerance relative to the size of the mesh, and equal costs are broken by vertex ids.
+ * Costs are compared exactly, so a float and a double build can collapse nearly equal edges in different orders.
+ * The simplification stops early when no collapse is left, so the result can have more triangles than asked.
+ */
+Mesh simplifyMesh(const Mesh &mesh, size_t targetTriangles);
+
+/**
+ * Levels of detail of mesh, each with about ratio times the triangles of the previous one, down to minTriangles.
+ * The mesh itself is not included.
+ */
+std::vector<Mesh> buildLods(const Mesh &mesh, size_t minTriangles = 32, double ratio = 0.5);
+
+#endif //CG_SIMPLIFY_H
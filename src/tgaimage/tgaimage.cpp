@@ -1,10 +1,39 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <cstdint>
 #include <cstring>
+#include <new>
 #include <time.h>
 #include <cmath>
 #include "tgaimage.h"
 
+unsigned char *TGAImage::allocate(unsigned long nbytes)
+{
+    // Rounded up to whole cache lines, so vector loops may run to the end of the last one
+    unsigned long size = (nbytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    return static_cast<unsigned char *>(::operator new[](size ? size : ALIGNMENT, std::align_val_t(ALIGNMENT)));
+}
+
+void TGAImage::release(unsigned char *p)
+{
+    if (p) ::operator delete[](p, std::align_val_t(ALIGNMENT));
+}
+
+void TGAImage::resize(int w, int h, int bpp)
+{
+    unsigned long old = (unsigned long) width * height * bytespp;
+    unsigned long nbytes = (unsigned long) w * h * bpp;
+    if (!data || nbytes != old)
+    {
+        release(data);
+        data = allocate(nbytes);
+    }
+    width = w;
+    height = h;
+    bytespp = bpp;
+}
+
 TGAImage::TGAImage() : data(nullptr), width(0), height(0), bytespp(0)
 {
 }
@@ -12,44 +41,62 @@ TGAImage::TGAImage() : data(nullptr), width(0), height(0), bytespp(0)
 TGAImage::TGAImage(int w, int h, int bpp) : data(nullptr), width(w), height(h), bytespp(bpp)
 {
     unsigned long nbytes = width * height * bytespp;
-    data = new unsigned char[nbytes];
+    data = allocate(nbytes);
     memset(data, 0, nbytes);
 }
 
-TGAImage::TGAImage(const TGAImage &img)
+TGAImage::TGAImage(const TGAImage &img) : data(nullptr), width(0), height(0), bytespp(0)
 {
-    width = img.width;
-    height = img.height;
-    bytespp = img.bytespp;
-    unsigned long nbytes = width * height * bytespp;
-    data = new unsigned char[nbytes];
-    memcpy(data, img.data, nbytes);
+    *this = img;
+}
+
+TGAImage::TGAImage(TGAImage &&img) noexcept : data(img.data), width(img.width), height(img.height),
+                                              bytespp(img.bytespp)
+{
+    img.data = nullptr;
+    img.width = img.height = img.bytespp = 0;
 }
 
 TGAImage::~TGAImage()
 {
-    if (data) delete[] data;
+    release(data);
 }
 
 TGAImage &TGAImage::operator=(const TGAImage &img)
 {
     if (this != &img)
     {
-        if (data) delete[] data;
+        if (!img.data)
+        {
+            release(data);
+            data = nullptr;
+            width = height = bytespp = 0;
+            return *this;
+        }
+        // The buffer is kept when the size matches: copying a frame into another costs the copy only
+        resize(img.width, img.height, img.bytespp);
+        memcpy(data, img.data, (unsigned long) width * height * bytespp);
+    }
+    return *this;
+}
+
+TGAImage &TGAImage::operator=(TGAImage &&img) noexcept
+{
+    if (this != &img)
+    {
+        release(data);
+        data = img.data;
         width = img.width;
         height = img.height;
         bytespp = img.bytespp;
-        unsigned long nbytes = width * height * bytespp;
-        data = new unsigned char[nbytes];
-        memcpy(data, img.data, nbytes);
+        img.data = nullptr;
+        img.width = img.height = img.bytespp = 0;
     }
     return *this;
 }
 
 bool TGAImage::read_tga_file(const char *filename)
 {
-    if (data) delete[] data;
-    data = nullptr;
     std::ifstream in;
     in.open(filename, std::ios::binary);
     if (!in.is_open())
@@ -66,17 +113,16 @@ bool TGAImage::read_tga_file(const char *filename)
         std::cerr << "an error occured while reading the header\n";
         return false;
     }
-    width = header.width;
-    height = header.height;
-    bytespp = header.bitsperpixel >> 3;
-    if (width <= 0 || height <= 0 || (bytespp != GRAYSCALE && bytespp != RGB && bytespp != RGBA))
+    int w = header.width, h = header.height, bpp = header.bitsperpixel >> 3;
+    if (w <= 0 || h <= 0 || (bpp != GRAYSCALE && bpp != RGB && bpp != RGBA))
     {
         in.close();
         std::cerr << "bad bpp (or width/height) value\n";
         return false;
     }
+    // Reading a file of the size of the image reuses its buffer
+    resize(w, h, bpp);
     unsigned long nbytes = bytespp * width * height;
-    data = new unsigned char[nbytes];
     if (3 == header.datatypecode || 2 == header.datatypecode)
     {
         in.read((char *) data, nbytes);
@@ -175,10 +221,6 @@ bool TGAImage::load_rle_data(std::ifstream &in)
 
 bool TGAImage::write_tga_file(const char *filename, bool rle)
 {
-    unsigned char developer_area_ref[4] = {0, 0, 0, 0};
-    unsigned char extension_area_ref[4] = {0, 0, 0, 0};
-    unsigned char footer[18] = {'T', 'R', 'U', 'E', 'V', 'I', 'S', 'I', 'O', 'N', '-', 'X', 'F', 'I', 'L', 'E', '.',
-                                '\0'};
     std::ofstream out;
     out.open(filename, std::ios::binary);
     if (!out.is_open())
@@ -187,6 +229,17 @@ bool TGAImage::write_tga_file(const char *filename, bool rle)
         out.close();
         return false;
     }
+    bool ok = write_tga(out, rle);
+    out.close();
+    return ok && out.good();
+}
+
+bool TGAImage::write_tga(std::ostream &out, bool rle)
+{
+    unsigned char developer_area_ref[4] = {0, 0, 0, 0};
+    unsigned char extension_area_ref[4] = {0, 0, 0, 0};
+    unsigned char footer[18] = {'T', 'R', 'U', 'E', 'V', 'I', 'S', 'I', 'O', 'N', '-', 'X', 'F', 'I', 'L', 'E', '.',
+                                '\0'};
     TGA_Header header{};
     memset((void *) &header, 0, sizeof(header));
     header.bitsperpixel = bytespp << 3;
@@ -197,7 +250,6 @@ bool TGAImage::write_tga_file(const char *filename, bool rle)
     out.write((char *) &header, sizeof(header));
     if (!out.good())
     {
-        out.close();
         std::cerr << "can't dump the tga file\n";
         return false;
     }
@@ -207,45 +259,29 @@ bool TGAImage::write_tga_file(const char *filename, bool rle)
         if (!out.good())
         {
             std::cerr << "can't unload raw data\n";
-            out.close();
             return false;
         }
     } else
     {
         if (!unload_rle_data(out))
         {
-            out.close();
             std::cerr << "can't unload rle data\n";
             return false;
         }
     }
     out.write((char *) developer_area_ref, sizeof(developer_area_ref));
-    if (!out.good())
-    {
-        std::cerr << "can't dump the tga file\n";
-        out.close();
-        return false;
-    }
     out.write((char *) extension_area_ref, sizeof(extension_area_ref));
-    if (!out.good())
-    {
-        std::cerr << "can't dump the tga file\n";
-        out.close();
-        return false;
-    }
     out.write((char *) footer, sizeof(footer));
     if (!out.good())
     {
         std::cerr << "can't dump the tga file\n";
-        out.close();
         return false;
     }
-    out.close();
     return true;
 }
 
 //  it is not necessary to break a raw chunk for two equal pixels (for the matter of the resulting size)
-bool TGAImage::unload_rle_data(std::ofstream &out)
+bool TGAImage::unload_rle_data(std::ostream &out)
 {
     const unsigned char max_chunk_length = 128;
     unsigned long npixels = width * height;
@@ -351,17 +387,14 @@ bool TGAImage::flip_vertically()
 {
     if (!data) return false;
     unsigned long bytes_per_line = width * bytespp;
-    unsigned char *line = new unsigned char[bytes_per_line];
     int half = height >> 1;
+    // Rows swapped in place: no scratch line to allocate
     for (int j = 0; j < half; j++)
     {
         unsigned long l1 = j * bytes_per_line;
         unsigned long l2 = (height - 1 - j) * bytes_per_line;
-        memmove((void *) line, (void *) (data + l1), bytes_per_line);
-        memmove((void *) (data + l1), (void *) (data + l2), bytes_per_line);
-        memmove((void *) (data + l2), (void *) line, bytes_per_line);
+        std::swap_ranges(data + l1, data + l1 + bytes_per_line, data + l2);
     }
-    delete[] line;
     return true;
 }
 
@@ -375,10 +408,41 @@ void TGAImage::clear()
     memset((void *) data, 0, width * height * bytespp);
 }
 
+void TGAImage::clear(const TGAColor &c)
+{
+    if (!data) return;
+    unsigned long npixels = (unsigned long) width * height;
+    if (bytespp == GRAYSCALE || (c.val == 0 && bytespp <= RGBA))
+    {
+        memset(data, c.raw[0], npixels * bytespp);
+    } else if (bytespp == RGBA)
+    {
+        // Whole pixels as 32 bit words, which the compiler turns into vector stores
+        uint32_t pixel;
+        memcpy(&pixel, c.raw, 4);
+        auto *out = reinterpret_cast<uint32_t *>(data);
+        std::fill(out, out + npixels, pixel);
+    } else
+    {
+        // Three byte pixels: fill one cache line multiple of them, 192 bytes, then copy it along the buffer
+        unsigned char pattern[3 * ALIGNMENT];
+        for (int i = 0; i < 3 * ALIGNMENT; i++)
+        {
+            pattern[i] = c.raw[i % 3];
+        }
+        unsigned long nbytes = npixels * 3, i = 0;
+        for (; i + sizeof(pattern) <= nbytes; i += sizeof(pattern))
+        {
+            memcpy(data + i, pattern, sizeof(pattern));
+        }
+        memcpy(data + i, pattern, nbytes - i);
+    }
+}
+
 bool TGAImage::scale(int w, int h)
 {
     if (w <= 0 || h <= 0 || !data) return false;
-    unsigned char *tdata = new unsigned char[w * h * bytespp];
+    unsigned char *tdata = allocate(w * h * bytespp);
     int nscanline = 0;
     int oscanline = 0;
     int erry = 0;
@@ -410,7 +474,7 @@ bool TGAImage::scale(int w, int h)
             nscanline += nlinebytes;
         }
     }
-    delete[] data;
+    release(data);
     data = tdata;
     width = w;
     height = h;
@@ -68,17 +68,29 @@ protected:
 	int bytespp;
 
 	bool   load_rle_data(std::ifstream &in);
-	bool unload_rle_data(std::ofstream &out);
+	bool unload_rle_data(std::ostream &out);
+
+	// Buffers are aligned on cache lines and padded to a whole number of them, for vector loads and stores
+	static unsigned char *allocate(unsigned long nbytes);
+	static void release(unsigned char *p);
+	// Reallocates, leaving the content undefined, only if the byte size changes
+	void resize(int w, int h, int bpp);
 public:
 	enum Format {
 		GRAYSCALE=1, RGB=3, RGBA=4
 	};
 
+	static constexpr int ALIGNMENT = 64;
+
 	TGAImage();
 	TGAImage(int w, int h, int bpp);
 	TGAImage(const TGAImage &img);
+	// Moves hand the buffer over: framebuffers pass between stages without a copy
+	TGAImage(TGAImage &&img) noexcept;
 	bool read_tga_file(const char *filename);
 	bool write_tga_file(const char *filename, bool rle=true);
+	// The bytes of write_tga_file, to any stream
+	bool write_tga(std::ostream &out, bool rle=true);
 	bool flip_horizontally();
 	bool flip_vertically();
 	bool scale(int w, int h);
@@ -86,11 +98,14 @@ public:
 	bool set(int x, int y, TGAColor c);
 	~TGAImage();
 	TGAImage & operator =(const TGAImage &img);
+	TGAImage & operator =(TGAImage &&img) noexcept;
 	int get_width();
 	int get_height();
 	int get_bytespp();
 	unsigned char *buffer();
 	void clear();
+	// Fill every pixel with c, at about the speed of memset
+	void clear(const TGAColor &c);
 };
 
 #endif //__IMAGE_H__
@@ -0,0 +1,632 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "render/FrameRing.h"
+#include "render/Image.h"
+#include "memory/HeapCounter.h"
+#include "render/ImageDiff.h"
+#include "scene/Scene.h"
+
+using namespace std;
+
+/**
+ * Renders a fixed set of scenes, framed to fill most of the image, and compares each to its golden TGA.
+ * A scene passes when at most 0.2% of the pixels it covers have a channel more than 2 away from the golden, which
+ * absorbs small rounding differences but not a misplaced edge or a wrong color. Covered pixels are those not black in
+ * the render or the golden, so the budget doesn't grow with empty background.
+ * Float and double precision builds compare to the same goldens, except for the scenes whose geometry depends on the
+ * precision: simplified meshes collapse nearly equal edges in a different order, so "scene" has a golden per
+ * precision.
+ * Frames drawn again into the same image, once warmed up, must not allocate from the heap, nor frames going through
+ * a FrameRing to their files, which must hold the bytes Image::save writes.
+ * Usage: goldentest goldenDir [--precision precisionDir] [--update] [--diff outDir]
+ *   --precision  directory of the goldens of this precision, for the scenes depending on it; goldenDir otherwise
+ *   --update     render the goldens again instead of comparing
+ *   --diff       write <scene>_diff.tga for every failing scene, mismatches in red
+ */
+namespace
+{
+    constexpr int size = 128;
+    constexpr int tolerance = 2;
+    constexpr double allowedMismatch = 0.002;
+
+    const TGAColor red(255, 0, 0, 255), green(0, 255, 0, 255), blue(0, 0, 255, 255), yellow(0, 128, 255, 255);
+
+    /**
+     * Looking down on the origin from 8 units up, the view spans about 2.4 units each way at z = 0, where the
+     * scenes lie
+     */
+    Mat4 perspective()
+    {
+        return makePerspectiveProjectTrans(-Real(1.5), -Real(1.5), -5, Real(1.5), Real(1.5), -10);
+    }
+
+    Mat4 camera()
+    {
+        return makeCameraTrans(Vec3(0, 0, 8), Vec3(0, 0, -1), Vec3{0, 1, 0});
+    }
+
+    vector<Triangle> tetrahedron()
+    {
+        Real r = Real(1.8), h = Real(1.5);
+        Point p1{{-r, -r, 0}, red}, p2{{r, r, 0}, yellow}, p3{{-r, r, h}, blue}, p4{{r, -r, h}, green};
+        return {Triangle(p1, p3, p4), Triangle(p2, p3, p4), Triangle(p1, p2, p4), Triangle(p1, p2, p3)};
+    }
+
+    void renderForward(Image &img)
+    {
+        for (auto &t: tetrahedron())
+        {
+            img.draw(t);
+        }
+    }
+
+    void renderDeferred(Image &img)
+    {
+        img.setShadingMode(Image::ShadingMode::Deferred);
+        renderForward(img);
+    }
+
+    void renderMultisample(Image &img)
+    {
+        img.setMultisample(4, SampleBuffer::Filter::Tent);
+        renderForward(img);
+    }
+
+    void renderLines(Image &img)
+    {
+        vector<Line> aliased, smooth;
+        for (int k = 0; k < 24; ++k)
+        {
+            Real a = 2 * Real(M_PI) * k / 24, c = std::cos(a), s = std::sin(a);
+            aliased.emplace_back(Point{{0, 0, 0}, red}, Point{{Real(2.2) * c, Real(2.2) * s, 0}, blue});
+            smooth.emplace_back(Point{{0, 0, 2}, red}, Point{{Real(1.5) * c, Real(1.5) * s, 2}, green});
+        }
+        img.drawLines(aliased);
+        img.setLineSmoothing(true);
+        img.drawLines(smooth);
+    }
+
+    vector<Triangle> grid()
+    {
+        vector<Triangle> triangles;
+        constexpr int cells = 16;
+        Real step = Real(4) / cells;
+        for (int j = 0; j < cells; ++j)
+        {
+            for (int i = 0; i < cells; ++i)
+            {
+                Real x = -2 + i * step, y = -2 + j * step, z = std::sin(x) * std::cos(y) * Real(0.5);
+                TGAColor c(static_cast<unsigned char>(i * 16), static_cast<unsigned char>(j * 16), 200, 255),
+                        d(200, static_cast<unsigned char>(i * 16), static_cast<unsigned char>(j * 16), 255);
+                Point p00{{x, y, z}, c}, p10{{x + step, y, z}, d}, p01{{x, y + step, z}, d},
+                        p11{{x + step, y + step, z}, c};
+                triangles.emplace_back(p00, p10, p11);
+                triangles.emplace_back(p00, p11, p01);
+            }
+        }
+        return triangles;
+    }
+
+    void renderBatch(Image &img)
+    {
+        img.drawTriangles(grid());
+    }
+
+    /**
+     * Square of side 2 centred at (x, y), at height z, in one translucent color
+     */
+    vector<Triangle> layer(Real x, Real y, Real z, const TGAColor &c)
+    {
+        Point p00{{x - 1, y - 1, z}, c}, p10{{x + 1, y - 1, z}, c}, p01{{x - 1, y + 1, z}, c},
+                p11{{x + 1, y + 1, z}, c};
+        return {Triangle(p00, p10, p11), Triangle(p00, p11, p01)};
+    }
+
+    void renderBlend(Image &img)
+    {
+        img.drawTriangles(grid());
+        img.setBlendMode(BlendMode::Over);
+        img.drawTriangles(layer(-1, -1, 1, TGAColor(255, 0, 0, 128)));
+        img.setBlendMode(BlendMode::Additive);
+        img.drawTriangles(layer(1, -1, 1, TGAColor(0, 255, 0, 96)));
+        img.setBlendMode(BlendMode::Premultiplied);
+        for (auto &t: layer(0, 1, 1, TGAColor(0, 0, 96, 128)))
+        {
+            img.draw(t);
+        }
+    }
+
+    vector<Triangle> transparentLayers()
+    {
+        vector<Triangle> triangles;
+        for (auto &t: layer(-Real(0.5), -Real(0.5), Real(0.5), TGAColor(255, 0, 0, 128)))
+        {
+            triangles.push_back(t);
+        }
+        for (auto &t: layer(Real(0.5), -Real(0.5), 1, TGAColor(0, 255, 0, 128)))
+        {
+            triangles.push_back(t);
+        }
+        for (auto &t: layer(0, Real(0.5), Real(1.5), TGAColor(0, 0, 255, 160)))
+        {
+            triangles.push_back(t);
+        }
+        return triangles;
+    }
+
+    void renderTransparent(Image &img)
+    {
+        img.drawTriangles(grid());
+        img.setOrderIndependent(true);
+        img.drawTriangles(transparentLayers());
+    }
+
+    void renderScene(Image &img)
+    {
+        img.setShadingMode(Image::ShadingMode::Deferred);
+        Mesh sphere;
+        constexpr int slices = 32, stacks = 16;
+        for (int j = 0; j <= stacks; ++j)
+        {
+            for (int i = 0; i <= slices; ++i)
+            {
+                Real theta = Real(M_PI) * j / stacks, phi = 2 * Real(M_PI) * i / slices;
+                sphere.addVertex(Vec3{std::sin(theta) * std::cos(phi), std::cos(theta),
+                                      std::sin(theta) * std::sin(phi)},
+                                 TGAColor(static_cast<unsigned char>(i * 8), static_cast<unsigned char>(j * 16), 160,
+                                          255));
+            }
+        }
+        for (uint32_t j = 0; j < stacks; ++j)
+        {
+            for (uint32_t i = 0; i < slices; ++i)
+            {
+                uint32_t a = j * (slices + 1) + i, b = a + 1, c = a + slices + 1, d = c + 1;
+                sphere.addTriangle(a, c, b);
+                sphere.addTriangle(b, c, d);
+            }
+        }
+        Scene scene;
+        auto mesh = scene.addMesh(std::move(sphere));
+        scene.generateLods(mesh);
+        auto root = scene.addNode();
+        for (int j = 0; j < 3; ++j)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                // Heights apart, so the spheres take different levels of detail
+                scene.addNode(root, Affine3::translate(Vec3{(i - 1) * Real(1.5), (j - 1) * Real(1.5),
+                                                            (i + j - 2) * Real(0.6)}) *
+                                    Affine3::scale(Vec3{Real(0.7), Real(0.7), Real(0.7)}), mesh);
+            }
+        }
+        scene.draw(img);
+    }
+
+    /**
+     * Pixels not black in a or b, of the same size and format
+     */
+    size_t coveredPixels(TGAImage &a, TGAImage &b)
+    {
+        size_t covered = 0, bytespp = a.get_bytespp();
+        size_t pixels = static_cast<size_t>(a.get_width()) * a.get_height();
+        const unsigned char *pa = a.buffer(), *pb = b.buffer();
+        for (size_t i = 0; i < pixels; ++i)
+        {
+            unsigned char any = 0;
+            for (size_t c = 0; c < bytespp; ++c)
+            {
+                any |= pa[i * bytespp + c] | pb[i * bytespp + c];
+            }
+            covered += any != 0;
+        }
+        return covered;
+    }
+
+    /**
+     * Image with the orientation save() writes
+     */
+    Image render(const function<void(Image &)> &draw)
+    {
+        Image img(size, size, perspective(), camera());
+        draw(img);
+        img.resolve();
+        img.flip_vertically();
+        return img;
+    }
+
+    /**
+     * Heap allocations of drawing, resolving and flipping a frame into an image that already drew a few, over a pool
+     * of several threads so the job queues are exercised even on a single core
+     * @return false if some configuration allocates
+     */
+    bool checkSteadyState()
+    {
+        JobSystem pool(4);
+        auto triangles = grid();
+        const pair<const char *, function<void(Image &)>> configurations[] = {
+                {"forward",   [](Image &) {}},
+                {"deferred",  [](Image &img) { img.setShadingMode(Image::ShadingMode::Deferred); }},
+                {"msaa_tent", [](Image &img) { img.setMultisample(4, SampleBuffer::Filter::Tent); }}};
+        bool ok = true;
+        for (auto &[name, configure]: configurations)
+        {
+            Image img(size, size, perspective(), camera());
+            img.setJobSystem(pool);
+            configure(img);
+            uint64_t before = 0;
+            for (int frame = 0; frame < 6; ++frame)
+            {
+                if (frame == 3)
+                {
+                    before = heapAllocations();
+                }
+                img.clear();
+                img.drawTriangles(triangles);
+                img.resolve();
+                img.flip_vertically();
+            }
+            auto allocations = heapAllocations() - before;
+            cout << name << " steady state: " << (allocations == 0 ? "ok" : "FAILED") << ", " << allocations
+                 << " heap allocations in 3 frames\n";
+            ok = ok && allocations == 0;
+        }
+        return ok;
+    }
+
+    /**
+     * Triangles with one vertex billions of pixels away are clipped to the guard band, not dropped: on the image,
+     * they must look the same as with that vertex in the same direction but near enough not to be clipped, in both
+     * the batch and the single triangle paths
+     */
+    bool checkGuardBand()
+    {
+        auto reaching = [](Real distance)
+        {
+            Point a{{Real(-0.6), Real(-0.7), 0}, red}, b{{Real(0.5), Real(-0.4), 0}, green};
+            Point c{{Real(0.7), Real(0.6), 0}, blue}, d{{Real(-0.5), Real(0.3), 0}, green};
+            return vector<Triangle>{
+                    Triangle(a, b, Point{{a[0] + Real(0.3) * distance, a[1] + distance, 0}, blue}),
+                    Triangle(c, d, Point{{c[0] - distance, c[1] - Real(0.2) * distance, 0}, red})};
+        };
+        auto draw = [&](Real distance, bool batch)
+        {
+            Image img(size, size, makeOrthographicProjectTrans(-1, -1, 1, 1, 1, -1),
+                      makeCameraTrans(Vec3(0, 0, 0), Vec3(0, 0, -1), Vec3(0, 1, 0)));
+            auto triangles = reaching(distance);
+            if (batch)
+            {
+                img.drawTriangles(triangles);
+            } else
+            {
+                for (auto &t: triangles)
+                {
+                    img.draw(t);
+                }
+            }
+            return img;
+        };
+        bool ok = true;
+        size_t worst = 0;
+        for (bool batch: {false, true})
+        {
+            // 64 pixels per unit: 6.4e6 pixels is inside the guard band, 6.4e9 far outside
+            auto near = draw(Real(1e5), batch), far = draw(Real(1e8), batch);
+            ImageDiff diff;
+            ok = compareImages(near, far, 2, diff) && diff.mismatched == 0 && ok;
+            worst = max(worst, diff.mismatched);
+        }
+        // Pixel coordinates past what 28.4 fixed point holds, flat so only coverage and the truncation of the
+        // interpolated color can differ
+        auto drawPixels = [&](int distance)
+        {
+            Image img(size, size, makeOrthographicProjectTrans(-1, -1, 1, 1, 1, -1),
+                      makeCameraTrans(Vec3(0, 0, 0), Vec3(0, 0, -1), Vec3(0, 1, 0)));
+            img.draw(0, 0, green, size - 1, 0, green, 0, distance, green);
+            img.draw(size - 1, size - 1, red, 0, size - 1, red, -distance, -distance, red);
+            return img;
+        };
+        auto near = drawPixels(1 << 20), far = drawPixels(2000000000);
+        ImageDiff diff;
+        ok = compareImages(near, far, 1, diff) && diff.mismatched == 0 && ok;
+        worst = max(worst, diff.mismatched);
+        cout << "guard band: " << (ok ? "ok" : "FAILED") << ", " << worst << " pixels differ\n";
+        return ok;
+    }
+
+    /**
+     * A frame drawn after clearing an image that already drew one, resolved or not, must be the frame drawn in a new
+     * image: nothing of the first may come back from the samples, the G-buffer or the transparency buffer
+     */
+    bool checkClearedFrame()
+    {
+        const pair<const char *, function<void(Image &)>> configurations[] = {
+                {"msaa_tent", [](Image &img) { img.setMultisample(4, SampleBuffer::Filter::Tent); }},
+                {"deferred",  [](Image &img) { img.setShadingMode(Image::ShadingMode::Deferred); }},
+                {"oit",       [](Image &img) { img.setOrderIndependent(true); }}};
+        bool ok = true;
+        for (auto &[name, configure]: configurations)
+        {
+            auto second = [&](Image &img)
+            {
+                configure(img);
+                renderForward(img);
+            };
+            auto reused = render([&](Image &img)
+                                 {
+                                     configure(img);
+                                     img.drawTriangles(grid());
+                                     img.resolve();
+                                     // Left unresolved, to be dropped by the clear
+                                     img.drawTriangles(grid());
+                                     img.drawTriangles(transparentLayers());
+                                     img.clear();
+                                     renderForward(img);
+                                 });
+            auto fresh = render(second);
+            ImageDiff diff;
+            bool same = compareImages(reused, fresh, 0, diff) && diff.mismatched == 0;
+            cout << name << " cleared frame: " << (same ? "ok" : "FAILED") << ", " << diff.mismatched
+                 << " pixels left from the previous frame\n";
+            ok = ok && same;
+        }
+        return ok;
+    }
+
+    /**
+     * Order-independent layers drawn in reverse order, one by one, must give the image drawn in order up to the
+     * rounding of the sums
+     */
+    bool checkOrderIndependence()
+    {
+        auto reversed = render([](Image &img)
+                               {
+                                   img.drawTriangles(grid());
+                                   img.setOrderIndependent(true);
+                                   auto triangles = transparentLayers();
+                                   for (auto t = triangles.rbegin(); t != triangles.rend(); ++t)
+                                   {
+                                       img.draw(*t);
+                                   }
+                               });
+        auto ordered = render(renderTransparent);
+        ImageDiff diff;
+        bool ok = compareImages(reversed, ordered, 1, diff) && diff.mismatched == 0;
+        cout << "order independence: " << (ok ? "ok" : "FAILED") << ", max error " << diff.maxError << "\n";
+        return ok;
+    }
+
+    bool checkRing()
+    {
+        JobSystem pool(4);
+        auto triangles = grid();
+        Image prototype(size, size, perspective(), camera());
+        prototype.setJobSystem(pool);
+        prototype.setShadingMode(Image::ShadingMode::Deferred);
+        auto dir = filesystem::temp_directory_path() / "cg_framering";
+        filesystem::create_directories(dir);
+        constexpr int frames = 12, warmup = 6;
+        vector<string> names;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            names.push_back((dir / ("frame" + to_string(100 + frame) + ".tga")).string());
+        }
+        bool ok = true;
+        uint64_t allocations = 0;
+        {
+            FrameRing ring(prototype);
+            uint64_t before = 0;
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                if (frame == warmup)
+                {
+                    ok = ring.finish();
+                    before = heapAllocations();
+                }
+                auto &img = ring.acquire();
+                img.clear();
+                img.drawTriangles(triangles);
+                ring.submit(names[frame].c_str());
+            }
+            ok = ring.finish() && ok;
+            allocations = heapAllocations() - before;
+        }
+        auto direct = (dir / "direct.tga").string();
+        prototype.drawTriangles(triangles);
+        ok = prototype.save(direct.c_str()) && ok;
+        auto read = [](const string &name)
+        {
+            ifstream in(name, ios::binary);
+            return string(istreambuf_iterator<char>(in), {});
+        };
+        bool same = read(direct) == read(names.back());
+        filesystem::remove_all(dir);
+        cout << "frame ring: " << (ok && same && allocations == 0 ? "ok" : "FAILED") << ", "
+             << (same ? "same bytes as save" : "bytes differ from save") << ", " << allocations
+             << " heap allocations in " << frames - warmup << " frames\n";
+        return ok && same && allocations == 0;
+    }
+
+    /**
+     * Axis aligned box of half side h around the origin, in one color
+     */
+    Mesh box(Real h, const TGAColor &c)
+    {
+        Mesh mesh;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            mesh.addVertex(Vec3{corner & 1 ? h : -h, corner & 2 ? h : -h, corner & 4 ? h : -h}, c);
+        }
+        // Two triangles per face, corners of the face listed by the bits that vary on it
+        const uint32_t faces[6][4] = {{0, 1, 3, 2}, {4, 6, 7, 5}, {0, 4, 5, 1}, {2, 3, 7, 6}, {0, 2, 6, 4},
+                                      {1, 5, 7, 3}};
+        for (auto &f: faces)
+        {
+            mesh.addTriangle(f[0], f[1], f[2]);
+            mesh.addTriangle(f[0], f[2], f[3]);
+        }
+        return mesh;
+    }
+
+    /**
+     * Behind a wall, a box it hides entirely is culled and a box reaching past its edge is kept, and culling leaves
+     * the deferred image as it is. Forward frames draw every node in the frustum.
+     */
+    bool checkOcclusionCulling()
+    {
+        Scene scene;
+        Mesh wall;
+        wall.addVertex(Vec3{-1, -1, 1}, red);
+        wall.addVertex(Vec3{1, -1, 1}, red);
+        wall.addVertex(Vec3{1, 1, 1}, red);
+        wall.addVertex(Vec3{-1, 1, 1}, red);
+        wall.addTriangle(0, 1, 2);
+        wall.addTriangle(0, 2, 3);
+        auto occluder = scene.addNode(scene.none, {}, scene.addMesh(std::move(wall)));
+        scene.setOccluder(occluder, true);
+        auto cube = scene.addMesh(box(Real(0.4), green));
+        scene.addNode(scene.none, Affine3::translate(Vec3{0, 0, -1}), cube);
+        scene.addNode(scene.none, Affine3::translate(Vec3{1, 0, -1}), cube);
+        auto draw = [&](bool culling, Image::ShadingMode mode, size_t &drawn)
+        {
+            scene.setOcclusionCulling(culling);
+            return render([&](Image &img)
+                          {
+                              img.setShadingMode(mode);
+                              drawn = scene.draw(img);
+                          });
+        };
+        size_t culled = 0, all = 0, forward = 0;
+        auto withCulling = draw(true, Image::ShadingMode::Deferred, culled);
+        auto without = draw(false, Image::ShadingMode::Deferred, all);
+        draw(true, Image::ShadingMode::Forward, forward);
+        ImageDiff diff;
+        bool same = compareImages(withCulling, without, 0, diff) && diff.mismatched == 0;
+        bool ok = same && culled == 2 && all == 3 && forward == 3;
+        cout << "occlusion culling: " << (ok ? "ok" : "FAILED") << ", " << culled << " of " << all
+             << " nodes drawn, " << diff.mismatched << " pixels changed\n";
+        return ok;
+    }
+
+    /**
+     * Time of comparing two 4K images, the size of the largest goldens the harness is meant for
+     */
+    void reportSpeed()
+    {
+        TGAImage a(3840, 2160, TGAImage::RGB), b(3840, 2160, TGAImage::RGB);
+        for (size_t i = 0; i < static_cast<size_t>(3840) * 2160 * 3; ++i)
+        {
+            a.buffer()[i] = static_cast<unsigned char>(i * 7);
+            b.buffer()[i] = static_cast<unsigned char>(i * 7 + (i % 1000 == 0));
+        }
+        ImageDiff diff;
+        constexpr int runs = 10;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < runs; ++i)
+        {
+            compareImages(a, b, 0, diff);
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / runs;
+        cout << "4K comparison: " << fixed << setprecision(2) << ms << " ms\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        cerr << "usage: " << argv[0] << " goldenDir [--precision precisionDir] [--update] [--diff outDir]\n";
+        return 2;
+    }
+    filesystem::path goldenDir = argv[1], precisionDir = argv[1], diffDir;
+    bool update = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--update") == 0)
+        {
+            update = true;
+        } else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc)
+        {
+            precisionDir = argv[++i];
+        } else if (strcmp(argv[i], "--diff") == 0 && i + 1 < argc)
+        {
+            diffDir = argv[++i];
+        } else
+        {
+            cerr << "unknown argument " << argv[i] << "\n";
+            return 2;
+        }
+    }
+    // Name, drawing, and whether the golden depends on the precision
+    const vector<tuple<const char *, function<void(Image &)>, bool>> scenes = {
+            {"forward",   renderForward,     false},
+            {"deferred",  renderDeferred,    false},
+            {"msaa_tent", renderMultisample, false},
+            {"lines",     renderLines,       false},
+            {"batch",     renderBatch,       false},
+            {"scene",     renderScene,       true},
+            {"blend",     renderBlend,       false},
+            {"oit",       renderTransparent, false}};
+    int failures = 0;
+    for (auto &[name, draw, perPrecision]: scenes)
+    {
+        auto img = render(draw);
+        auto golden = ((perPrecision ? precisionDir : goldenDir) / (string(name) + ".tga")).string();
+        if (update)
+        {
+            if (!img.write_tga_file(golden.c_str()))
+            {
+                ++failures;
+            }
+            continue;
+        }
+        TGAImage expected;
+        ImageDiff diff;
+        TGAImage diffImage;
+        if (!expected.read_tga_file(golden.c_str()) ||
+            !compareImages(img, expected, tolerance, diff, diffDir.empty() ? nullptr : &diffImage))
+        {
+            cout << name << ": FAILED, no golden of the right size\n";
+            ++failures;
+            continue;
+        }
+        auto covered = coveredPixels(img, expected);
+        bool ok = static_cast<double>(diff.mismatched) <= allowedMismatch * static_cast<double>(covered);
+        cout << name << ": " << (ok ? "ok" : "FAILED") << ", max error " << diff.maxError << ", PSNR "
+             << fixed << setprecision(2) << diff.psnr << " dB, " << diff.mismatched << " mismatched of " << covered
+             << " covered pixels\n";
+        if (!ok)
+        {
+            ++failures;
+            if (!diffDir.empty())
+            {
+                filesystem::create_directories(diffDir);
+                diffImage.write_tga_file((diffDir / (string(name) + "_diff.tga")).string().c_str());
+            }
+        }
+    }
+    if (!update)
+    {
+        failures += !checkSteadyState();
+        failures += !checkRing();
+        failures += !checkOrderIndependence();
+        failures += !checkClearedFrame();
+        failures += !checkGuardBand();
+        failures += !checkOcclusionCulling();
+        reportSpeed();
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <latch>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "asset/AssetCache.h"
+#include "UnitTest.h"
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    constexpr int side = 16;
+    /**
+     * Memory the cache counts for a texture of side x side RGB pixels
+     */
+    constexpr size_t textureBytes = sizeof(TGAImage) + side * side * 3;
+
+    bool writeTexture(const fs::path &path, unsigned char shade)
+    {
+        TGAImage image(side, side, TGAImage::RGB);
+        for (int y = 0; y < side; ++y)
+        {
+            for (int x = 0; x < side; ++x)
+            {
+                image.set(x, y, TGAColor(shade, shade, shade, 255));
+            }
+        }
+        return image.write_tga_file(path.string().c_str(), false);
+    }
+
+    /**
+     * Cache whose loader throws until told otherwise
+     */
+    class FailingCache : public AssetCache
+    {
+    public:
+        std::shared_ptr<const int> load(const fs::path &path, const std::function<void()> &before, bool fail)
+        {
+            return std::static_pointer_cast<const int>(get('i', path, [&](const std::string &) -> Loaded
+            {
+                before();
+                if (fail)
+                {
+                    throw std::runtime_error("decoder failed");
+                }
+                return {std::make_shared<int>(7), sizeof(int)};
+            }));
+        }
+    };
+
+    /**
+     * Threads asking for the same texture at once share one decode and one asset
+     */
+    bool checkSingleLoad(const fs::path &dir)
+    {
+        auto path = dir / "shared.tga";
+        if (!writeTexture(path, 10))
+        {
+            return false;
+        }
+        AssetCache cache;
+        constexpr int threads = 8;
+        std::latch start(threads);
+        std::vector<std::shared_ptr<const TGAImage>> got(threads);
+        std::vector<std::thread> requests;
+        for (int t = 0; t < threads; ++t)
+        {
+            requests.emplace_back([&, t]
+                                  {
+                                      start.arrive_and_wait();
+                                      got[t] = cache.getTexture(path);
+                                  });
+        }
+        for (auto &r: requests)
+        {
+            r.join();
+        }
+        bool same = got[0] && std::all_of(got.begin(), got.end(), [&](auto &p) { return p == got[0]; });
+        auto stats = cache.getStats();
+        return same && stats.loads == 1 && stats.hits == threads - 1 && stats.bytes == textureBytes;
+    }
+
+    /**
+     * Past the budget the least recently used texture goes first, and a texture in use is never dropped
+     */
+    bool checkEviction(const fs::path &dir)
+    {
+        fs::path a = dir / "a.tga", b = dir / "b.tga", c = dir / "c.tga";
+        if (!writeTexture(a, 1) || !writeTexture(b, 2) || !writeTexture(c, 3))
+        {
+            return false;
+        }
+        AssetCache cache(2 * textureBytes);
+        cache.getTexture(a);
+        cache.getTexture(b);
+        // a used again, so b is now the least recent
+        cache.getTexture(a);
+        cache.getTexture(c);
+        auto stats = cache.getStats();
+        bool lru = stats.evictions == 1 && stats.entries == 2 && stats.bytes == 2 * textureBytes;
+        cache.getTexture(a);
+        cache.getTexture(c);
+        lru = lru && cache.getStats().loads == stats.loads;
+        // b comes back, as the most recent, and a, the least recent, leaves
+        cache.getTexture(b);
+        lru = lru && cache.getStats().loads == stats.loads + 1 && cache.getStats().evictions == 2;
+        // Held, a stays loaded whatever the budget
+        auto held = cache.getTexture(c);
+        cache.setBudget(1);
+        auto after = cache.getStats();
+        bool kept = after.entries == 1 && after.bytes == textureBytes && cache.getTexture(c) == held &&
+                    cache.getStats().loads == after.loads;
+        held.reset();
+        cache.clear();
+        return lru && kept && cache.getStats().entries == 0;
+    }
+
+    /**
+     * A file modified on disk is loaded again, while the old version stays valid for whoever holds it
+     */
+    bool checkModified(const fs::path &dir)
+    {
+        auto path = dir / "edited.tga";
+        if (!writeTexture(path, 50))
+        {
+            return false;
+        }
+        AssetCache cache;
+        auto before = cache.getTexture(path);
+        if (!writeTexture(path, 200))
+        {
+            return false;
+        }
+        fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(10));
+        auto after = cache.getTexture(path);
+        return before && after && before != after && before.use_count() == 1 && cache.getStats().loads == 2 &&
+               cache.getStats().bytes == textureBytes;
+    }
+
+    /**
+     * A load that throws throws in the request waiting for it too, and the next request loads again instead of
+     * finding a broken promise
+     */
+    bool checkFailedLoad(const fs::path &dir)
+    {
+        auto path = dir / "broken.bin";
+        FailingCache cache;
+        auto waiter = std::async(std::launch::async, [&]
+        {
+            // Asks once the first request is loading, then waits for it
+            while (cache.getStats().loads == 0)
+            {
+                std::this_thread::yield();
+            }
+            try
+            {
+                cache.load(path, [] {}, false);
+            } catch (const std::runtime_error &)
+            {
+                return true;
+            }
+            // Came after the failed load was dropped: loaded again, which is fine too
+            return cache.getStats().loads == 2;
+        });
+        bool thrown = false;
+        try
+        {
+            cache.load(path, [&]
+            {
+                // Give the waiter the time to find the entry loading
+                while (cache.getStats().hits == 0 &&
+                       waiter.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+                {
+                }
+            }, true);
+        } catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        bool waited = waiter.get();
+        auto retried = cache.load(path, [] {}, false);
+        return thrown && waited && retried && *retried == 7 && cache.getStats().entries == 1;
+    }
+}
+
+bool testAssetCache()
+{
+    auto dir = fs::temp_directory_path() / "cg_assetcache";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    bool ok = report("asset loaded once", checkSingleLoad(dir));
+    ok = report("asset eviction", checkEviction(dir)) && ok;
+    ok = report("modified asset", checkModified(dir)) && ok;
+    ok = report("failed asset load", checkFailedLoad(dir)) && ok;
+    fs::remove_all(dir);
+    return ok;
+}
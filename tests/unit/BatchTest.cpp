@@ -0,0 +1,145 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cmath>
+#include <string_view>
+#include "batch/Batch.h"
+#include "UnitTest.h"
+
+namespace
+{
+    bool near(const Vec3 &l, const Vec3 &r)
+    {
+        auto d = l - r;
+        return std::sqrt(d.dot(d)) < Real(1e-4);
+    }
+
+    bool sameMat(const Mat4 &l, const Mat4 &r)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+            {
+                if (l[i][j] != r[i][j])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Every kind of line with its options, comments, blank lines and Windows line ends
+     */
+    bool checkValid()
+    {
+        constexpr std::string_view text =
+                "# scene\n"
+                "\n"
+                "mesh cube models/cube.obj   # comment after a line\r\n"
+                "mesh tri /abs/tri.obj\n"
+                "object cube\n"
+                "object tri scale 2 2 2 rotate 0 0 1 90 translate 1 0 0\n"
+                "  camera front eye 0 0 3 gaze 0 0 -1 up 0 1 0 perspective -1 -1 -1 1 1 -10\n"
+                "camera side\teye 3 0 0 gaze -1 0 0 up 0 1 0 orthographic -2 -2 -1 2 2 -10\n"
+                "job front 64 48 out/front.tga\n"
+                "job side 32 32 side.tga deferred msaa 8 tent\r\n"
+                "job front 16 16 small.tga msaa 4 tent box";
+        Batch batch;
+        if (!parseBatch(text, "base", batch))
+        {
+            return false;
+        }
+        bool ok = batch.meshNames.size() == 2 && batch.meshNames[1] == "tri" &&
+                  batch.meshPaths[0] == std::filesystem::path("base") / "models/cube.obj" &&
+                  batch.meshPaths[1] == "/abs/tri.obj";
+        ok = ok && batch.objects.size() == 2 && batch.objects[0].mesh == 0 && batch.objects[1].mesh == 1 &&
+             batch.objects[0].world == Affine3();
+        // Scaled to (2, 0, 0), turned a quarter about z to (0, 2, 0), then moved
+        ok = ok && near(batch.objects[1].world.apply(Vec3{1, 0, 0}), Vec3{1, 2, 0});
+        ok = ok && batch.cameras.size() == 2 && batch.cameras[1].name == "side" &&
+             sameMat(batch.cameras[0].projection, makePerspectiveProjectTrans(-1, -1, -1, 1, 1, -10)) &&
+             sameMat(batch.cameras[1].projection, makeOrthographicProjectTrans(-2, -2, -1, 2, 2, -10)) &&
+             sameMat(batch.cameras[1].view, makeCameraTrans({3, 0, 0}, {-1, 0, 0}, {0, 1, 0}));
+        ok = ok && batch.jobs.size() == 3;
+        if (!ok)
+        {
+            return false;
+        }
+        auto &front = batch.jobs[0], &side = batch.jobs[1], &small = batch.jobs[2];
+        ok = front.camera == 0 && front.width == 64 && front.height == 48 &&
+             front.output == (std::filesystem::path("base") / "out/front.tga").string() &&
+             front.shading == Image::ShadingMode::Forward && front.samples == 1 &&
+             front.filter == SampleBuffer::Filter::Box;
+        ok = ok && side.camera == 1 && side.shading == Image::ShadingMode::Deferred && side.samples == 8 &&
+             side.filter == SampleBuffer::Filter::Tent;
+        // The last filter written wins
+        ok = ok && small.samples == 4 && small.filter == SampleBuffer::Filter::Box;
+        // Parsing again replaces the content
+        ok = ok && parseBatch("# nothing\n", "base", batch) && batch.meshNames.empty() && batch.jobs.empty();
+        return ok;
+    }
+
+    /**
+     * Each text has one bad line after valid ones, and must be rejected
+     */
+    bool checkMalformed()
+    {
+        constexpr std::string_view head =
+                "mesh cube cube.obj\n"
+                "camera cam eye 0 0 3 gaze 0 0 -1 up 0 1 0 perspective -1 -1 -1 1 1 -10\n";
+        constexpr std::string_view bad[] = {
+                "meshes cube cube.obj",
+                "mesh other",
+                "mesh cube again.obj",
+                "mesh other other.obj extra",
+                "object",
+                "object sphere",
+                "object cube translate 1 2",
+                "object cube translate 1 2 z",
+                "object cube rotate 0 0 1",
+                "object cube shear 1 0 0",
+                "object cube scale 1 1 1x",
+                "camera",
+                "camera c2 eye 0 0 3 gaze 0 0 -1 perspective -1 -1 -1 1 1 -10",
+                "camera c2 eye 0 0 3 gaze 0 0 -1 up 0 1 0 fisheye -1 -1 -1 1 1 -10",
+                "camera c2 eye 0 0 3 gaze 0 0 -1 up 0 1 0 perspective -1 -1 -1 1 1",
+                "camera c2 eye 0 0 3 gaze 0 0 -1 up 0 1 0 perspective -1 -1 -1 1 1 -10 0",
+                "job",
+                "job nowhere 8 8 out.tga",
+                "job cam 8 out.tga",
+                "job cam 0 8 out.tga",
+                "job cam 8 -8 out.tga",
+                "job cam 8.5 8 out.tga",
+                "job cam 8 8",
+                "job cam 8 8 out.tga msaa 2",
+                "job cam 8 8 out.tga msaa",
+                "job cam 8 8 out.tga bilinear",
+        };
+        bool ok = true;
+        for (auto line: bad)
+        {
+            Batch batch;
+            std::string text(head);
+            text += line;
+            text += "\njob cam 8 8 out.tga\n";
+            if (parseBatch(text, ".", batch))
+            {
+                std::cout << "  accepted: " << line << "\n";
+                ok = false;
+            }
+        }
+        // The head alone is valid, so the rejections above come from the bad lines
+        Batch batch;
+        return ok && parseBatch(head, ".", batch);
+    }
+}
+
+bool testBatch()
+{
+    bool ok = report("batch valid", checkValid());
+    ok = report("batch malformed", checkMalformed()) && ok;
+    return ok;
+}
@@ -0,0 +1,96 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <random>
+#include <vector>
+#include "linear/Mat.h"
+#include "scene/Bvh.h"
+#include "UnitTest.h"
+
+namespace
+{
+    AABB randomBox(std::mt19937 &random, Real spread)
+    {
+        std::uniform_real_distribution<Real> position(-spread, spread), size(Real(0.1), Real(1));
+        Vec3 min{position(random), position(random), position(random)};
+        return {min, {min[0] + size(random), min[1] + size(random), min[2] + size(random)}};
+    }
+
+    /**
+     * Whether the query visits exactly the items whose box isn't outside, which only holds if every node box
+     * encloses its items and no more than the tree needs: a stale box either drops items or lets a subtree tested
+     * inside pass items that left it
+     */
+    bool queryMatches(const Bvh &bvh, const std::vector<AABB> &boxes, const Frustum &frustum)
+    {
+        std::vector<uint8_t> visited(boxes.size(), 0);
+        bool ok = true;
+        bvh.query(frustum, [&](uint32_t item)
+        {
+            ok = ok && !visited[item];
+            visited[item] = 1;
+        });
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            ok = ok && visited[i] == (frustum.test(boxes[i]) != Frustum::Test::Outside);
+        }
+        return ok;
+    }
+
+    /**
+     * Move a few items per frame, some of them several times, and refit only their paths; then move most of the
+     * items, which takes the full pass. Queries through windows across the spread check the node boxes every frame.
+     */
+    bool checkPartialRefit()
+    {
+        constexpr int itemCount = 500, frames = 200;
+        constexpr Real spread = 20;
+        std::mt19937 random(7);
+        std::vector<AABB> boxes;
+        for (int i = 0; i < itemCount; ++i)
+        {
+            boxes.push_back(randomBox(random, spread));
+        }
+        Bvh bvh;
+        bvh.build(boxes);
+        Mat4 camera({1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1});
+        std::vector<Frustum> windows;
+        for (Real x = -spread; x < spread; x += 8)
+        {
+            for (Real y = -spread; y < spread; y += 8)
+            {
+                windows.emplace_back(makeOrthographicProjectTrans(x, y, 5, x + 10, y + 10, -5), camera);
+            }
+        }
+        std::uniform_int_distribution<uint32_t> pick(0, itemCount - 1);
+        std::vector<uint32_t> moved;
+        bool ok = true;
+        for (int frame = 0; frame < frames && ok; ++frame)
+        {
+            moved.clear();
+            size_t count = frame % 50 == 49 ? itemCount : frame % 7 + 1;
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto item = count == itemCount ? static_cast<uint32_t>(i) : pick(random);
+                boxes[item] = randomBox(random, spread);
+                moved.push_back(item);
+                if (i % 3 == 0)
+                {
+                    moved.push_back(item);
+                }
+            }
+            bvh.refit(moved, boxes);
+            for (auto &window: windows)
+            {
+                ok = ok && queryMatches(bvh, boxes, window);
+            }
+        }
+        return ok;
+    }
+}
+
+bool testBvh()
+{
+    return report("bvh partial refit", checkPartialRefit());
+}
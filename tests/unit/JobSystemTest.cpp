@@ -0,0 +1,102 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <atomic>
+#include "job/JobSystem.h"
+#include "UnitTest.h"
+
+namespace
+{
+    /**
+     * Stages A -> B -> C, each starting only once the one before is done, plus jobs fanning out from A and a job
+     * depending on a counter already done, over many frames so that parking races with the last job of a stage
+     */
+    bool checkDependencies()
+    {
+        JobSystem jobs(4);
+        constexpr int frames = 2000, width = 4, fan = 8;
+        bool ordered = true, complete = true;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            JobSystem::Counter a, b, c, fanned, late;
+            std::atomic<int> doneA{0}, doneB{0}, doneC{0}, doneFan{0}, doneLate{0};
+            std::atomic<bool> outOfOrder{false};
+            for (int i = 0; i < width; ++i)
+            {
+                jobs.run([&] { doneA.fetch_add(1); }, &a);
+            }
+            for (int i = 0; i < width; ++i)
+            {
+                jobs.run([&]
+                         {
+                             outOfOrder.store(outOfOrder.load() || doneA.load() != width);
+                             doneB.fetch_add(1);
+                         }, &b, &a);
+            }
+            jobs.run([&]
+                     {
+                         outOfOrder.store(outOfOrder.load() || doneB.load() != width);
+                         doneC.fetch_add(1);
+                     }, &c, &b);
+            for (int i = 0; i < fan; ++i)
+            {
+                jobs.run([&]
+                         {
+                             outOfOrder.store(outOfOrder.load() || doneA.load() != width);
+                             doneFan.fetch_add(1);
+                         }, &fanned, &a);
+            }
+            jobs.wait(c);
+            jobs.wait(fanned);
+            jobs.run([&] { doneLate.fetch_add(1); }, &late, &a);
+            jobs.wait(late);
+            ordered = ordered && !outOfOrder.load();
+            complete = complete && a.done() && b.done() && doneA.load() == width && doneB.load() == width &&
+                       doneC.load() == 1 && doneFan.load() == fan && doneLate.load() == 1;
+        }
+        return ordered && complete;
+    }
+
+    /**
+     * Dependent jobs submitted by jobs on the workers, which push to queues of their own, still start only once the
+     * stage they depend on is done, and are waited for with their counter
+     */
+    bool checkNestedDependencies()
+    {
+        JobSystem jobs(4);
+        bool ok = true;
+        for (int frame = 0; frame < 500; ++frame)
+        {
+            JobSystem::Counter a, spawners, inner;
+            std::atomic<int> doneA{0}, doneInner{0};
+            std::atomic<bool> outOfOrder{false};
+            for (int i = 0; i < 4; ++i)
+            {
+                jobs.run([&] { doneA.fetch_add(1); }, &a);
+            }
+            for (int i = 0; i < 4; ++i)
+            {
+                jobs.run([&]
+                         {
+                             jobs.run([&]
+                                      {
+                                          outOfOrder.store(outOfOrder.load() || doneA.load() != 4);
+                                          doneInner.fetch_add(1);
+                                      }, &inner, &a);
+                         }, &spawners);
+            }
+            jobs.wait(spawners);
+            jobs.wait(inner);
+            ok = ok && !outOfOrder.load() && doneInner.load() == 4;
+        }
+        return ok;
+    }
+}
+
+bool testJobSystem()
+{
+    bool ok = report("job dependencies", checkDependencies());
+    ok = report("nested job dependencies", checkNestedDependencies()) && ok;
+    return ok;
+}
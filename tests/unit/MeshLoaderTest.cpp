@@ -0,0 +1,217 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "scene/MeshLoader.h"
+#include "UnitTest.h"
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    bool sameMesh(const Mesh &a, const Mesh &b)
+    {
+        if (a.vertexCount() != b.vertexCount() || a.indices != b.indices)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.vertexCount(); ++i)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                if (a.positions[i][k] != b.positions[i][k])
+                {
+                    return false;
+                }
+            }
+            if (a.colors[i].val != b.colors[i].val)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool writeText(const fs::path &path, const std::string &text)
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << text;
+        return static_cast<bool>(out);
+    }
+
+    std::string readBytes(const fs::path &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), {}};
+    }
+
+    /**
+     * Face vertices in every form, absolute or counting back from the last vertex, each OBJ vertex becoming one
+     * mesh vertex in order of first use, and polygons fanned
+     */
+    bool checkParse()
+    {
+        const char *text = "# square and a triangle\n"
+                           "v 0 0 0\n"
+                           "v 1 0 0 1 0 0\n"
+                           "v 1 1 0\n"
+                           "v 0 1 0\n"
+                           "v 5 5 5\n"
+                           "vt 0 0\n"
+                           "vn 0 0 1\n"
+                           "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+                           "f -5//1 -3 -2/1\n";
+        Mesh mesh;
+        if (!parseObj(text, mesh))
+        {
+            return false;
+        }
+        // The fifth vertex is used by no face
+        bool ok = mesh.vertexCount() == 4 && mesh.indices == std::vector<uint32_t>{0, 1, 2, 0, 2, 3, 0, 2, 3};
+        ok = ok && mesh.positions[1][0] == 1 && mesh.positions[3][1] == 1 && mesh.colors[1].r == 255 &&
+             mesh.colors[1].g == 0 && mesh.colors[0].g == 255;
+        // Malformed lines and indices out of range are refused
+        Mesh bad;
+        return ok && !parseObj("v 0 0\n", bad) && !parseObj("v 0 0 0\nf 1 2 3\n", bad) &&
+               !parseObj("v 0 0 0\nf -2 1 1\n", bad) && !parseObj("v 0 0 0\nf 1 x 1\n", bad);
+    }
+
+    /**
+     * A cache reads back as the mesh written, and only for the source size and time it was written with
+     */
+    bool checkCache(const fs::path &dir)
+    {
+        Mesh mesh;
+        if (!parseObj("v 0.1 0.2 0.3 0.5 0.25 1\nv 1e-7 -3.75 1e6\nv 2 4 8\nv 3 3 3\nf 1 2 3 4\n", mesh))
+        {
+            return false;
+        }
+        auto cache = (dir / "mesh.cgmesh").string();
+        Mesh read;
+        bool roundTrip = writeMeshCache(cache.c_str(), mesh, 123, 456) &&
+                         readMeshCache(cache.c_str(), read, 123, 456) && sameMesh(mesh, read);
+        bool stale = !readMeshCache(cache.c_str(), read, 124, 456) && !readMeshCache(cache.c_str(), read, 123, 457);
+        // Only the cache is left in the directory, no temporary file
+        size_t files = std::distance(fs::directory_iterator(dir), fs::directory_iterator());
+        return roundTrip && stale && files == 1;
+    }
+
+    /**
+     * The cache of a build of the other precision, the same in all but the size of its positions, is refused, and
+     * loading goes back to the OBJ and rewrites the cache in this precision
+     */
+    bool checkOtherPrecision(const fs::path &dir)
+    {
+        using Other = std::conditional_t<std::is_same_v<Real, double>, float, double>;
+        auto obj = dir / "precision.obj";
+        auto cache = fs::path(obj.string() + ".cgmesh");
+        Mesh parsed, loaded;
+        if (!writeText(obj, "v 0.1 0.2 0.3\nv 1 0 0\nv 0 1 0\nf 1 2 3\n") || !loadObj(obj.string().c_str(), parsed) ||
+            !loadMesh(obj.string().c_str(), loaded) || !fs::exists(cache))
+        {
+            return false;
+        }
+        // Header, then positions, colors and indices: the header ends with the size of Real and 4 bytes of padding
+        auto bytes = readBytes(cache);
+        size_t header = bytes.size() - parsed.vertexCount() * (3 * sizeof(Real) + 4) - parsed.indices.size() * 4;
+        std::string other = bytes.substr(0, header);
+        auto otherSize = static_cast<uint32_t>(sizeof(Other));
+        memcpy(other.data() + header - 8, &otherSize, sizeof(otherSize));
+        for (auto &p: parsed.positions)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                auto v = static_cast<Other>(p[k]);
+                other.append(reinterpret_cast<const char *>(&v), sizeof(v));
+            }
+        }
+        other += bytes.substr(header + parsed.vertexCount() * 3 * sizeof(Real));
+        if (!writeText(cache, other))
+        {
+            return false;
+        }
+        Mesh rejected;
+        auto size = fs::file_size(obj);
+        auto time = static_cast<int64_t>(fs::last_write_time(obj).time_since_epoch().count());
+        bool refused = !readMeshCache(cache.string().c_str(), rejected, size, time);
+        bool reloaded = loadMesh(obj.string().c_str(), loaded) && sameMesh(parsed, loaded) &&
+                        readMeshCache(cache.string().c_str(), rejected, size, time) && sameMesh(parsed, rejected);
+        return refused && reloaded;
+    }
+
+    /**
+     * Changing the OBJ file, in size or only in time, makes loading parse it again instead of using the cache
+     */
+    bool checkStaleSource(const fs::path &dir)
+    {
+        auto obj = dir / "stale.obj";
+        Mesh first, second, third;
+        if (!writeText(obj, "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n") || !loadMesh(obj.string().c_str(), first))
+        {
+            return false;
+        }
+        bool resized = writeText(obj, "v 0 0 0\nv 2 0 0\nv 0 2 0\nf 1 2 3\n# longer\n") &&
+                       loadMesh(obj.string().c_str(), second) && second.positions[1][0] == 2;
+        // Same size, different content: only the modification time tells
+        bool retimed = writeText(obj, "v 0 0 0\nv 3 0 0\nv 0 3 0\nf 1 2 3\n# longer\n");
+        fs::last_write_time(obj, fs::last_write_time(obj) + std::chrono::seconds(10));
+        retimed = retimed && loadMesh(obj.string().c_str(), third) && third.positions[1][0] == 3;
+        return first.positions[1][0] == 1 && resized && retimed;
+    }
+
+    /**
+     * Threads writing the same cache at once each rename a whole file of their own, so every write succeeds and the
+     * cache left reads back
+     */
+    bool checkConcurrentWrites(const fs::path &dir)
+    {
+        Mesh mesh;
+        if (!parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 4 3\n", mesh))
+        {
+            return false;
+        }
+        auto cache = (dir / "shared.cgmesh").string();
+        std::vector<std::thread> writers;
+        std::vector<char> written(4, 1);
+        for (size_t t = 0; t < written.size(); ++t)
+        {
+            writers.emplace_back([&, t]
+                                 {
+                                     for (int i = 0; i < 50; ++i)
+                                     {
+                                         written[t] = writeMeshCache(cache.c_str(), mesh, 1, 2) && written[t];
+                                     }
+                                 });
+        }
+        for (auto &w: writers)
+        {
+            w.join();
+        }
+        Mesh read;
+        bool all = std::find(written.begin(), written.end(), 0) == written.end();
+        return all && readMeshCache(cache.c_str(), read, 1, 2) && sameMesh(mesh, read);
+    }
+}
+
+bool testMeshLoader()
+{
+    auto dir = fs::temp_directory_path() / "cg_meshloader";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "cache");
+    bool ok = report("obj parsing", checkParse());
+    ok = report("mesh cache round trip", checkCache(dir / "cache")) && ok;
+    ok = report("mesh cache of the other precision", checkOtherPrecision(dir)) && ok;
+    ok = report("stale mesh cache", checkStaleSource(dir)) && ok;
+    ok = report("concurrent mesh cache writes", checkConcurrentWrites(dir)) && ok;
+    fs::remove_all(dir);
+    return ok;
+}
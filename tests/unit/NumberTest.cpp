@@ -0,0 +1,105 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <climits>
+#include <stdexcept>
+#include "Number.h"
+#include "linear/Mat.h"
+#include "linear/Vec.h"
+#include "UnitTest.h"
+
+namespace
+{
+    // The arithmetic is usable in constant expressions, reduction included
+    static_assert(Number(1, 2) + Number(1, 3) == Number(5, 6));
+    static_assert(Number(6, -4).numerator() == -3 && Number(6, -4).denominator() == 2);
+    static_assert(Number(2, 3) * Number(3, 4) / Number(1, 2) == 1);
+    static_assert(Number(1, 3) < Number(1, 2) && -Number(1, 2) < Number(-1, 3));
+
+    template<typename F>
+    bool throwsOverflow(F &&f)
+    {
+        try
+        {
+            f();
+        } catch (const std::overflow_error &)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Fractions are kept with a positive denominator prime to the numerator, so equal values compare equal
+     */
+    bool checkNormalization()
+    {
+        Number half(3, 6), zero(0, -7), negative(10, -4), sum = Number(1, 6) + Number(1, 3);
+        return half == Number(1, 2) && half.denominator() == 2 && zero == 0 && zero.denominator() == 1 &&
+               negative.numerator() == -5 && negative.denominator() == 2 && sum == Number(1, 2) &&
+               (Number(1, 4) + Number(3, 4)).isInteger();
+    }
+
+    /**
+     * Results leaving 64 bits on the way are redone in 128 bits and reduced, and only a result that still doesn't fit
+     * throws
+     */
+    bool checkOverflow()
+    {
+        bool wide = Number(1LL << 62) * Number(4, 1LL << 40) == Number(1 << 24) &&
+                    Number(LLONG_MAX, 2) + Number(LLONG_MAX, 2) == LLONG_MAX &&
+                    Number(LLONG_MIN, 3) - Number(LLONG_MAX, 3) == -6148914691236517205LL &&
+                    Number(LLONG_MAX) / Number(LLONG_MAX, 5) == 5;
+        bool throws = throwsOverflow([] { return Number(LLONG_MAX) + Number(1); }) &&
+                      throwsOverflow([] { return Number(LLONG_MIN) - Number(1); }) &&
+                      throwsOverflow([] { return -Number(LLONG_MIN); }) &&
+                      throwsOverflow([] { return Number(1LL << 40) * Number(1LL << 40); }) &&
+                      throwsOverflow([] { return Number(1, LLONG_MAX) * Number(1, 3); });
+        // Comparison cross multiplies in 128 bits and never throws
+        bool compares = Number(LLONG_MAX - 1, LLONG_MAX) < Number(LLONG_MAX, LLONG_MAX - 1);
+        return wide && throws && compares;
+    }
+
+    /**
+     * At a billion units, double products lose the last units and call a clockwise triangle collinear; with Number
+     * the sign is exact, and a product that can't be held throws rather than being wrong
+     */
+    bool checkOrient()
+    {
+        using NVec2 = Vec<Number, 2>;
+        constexpr long long big = 1000000000;
+        NVec2 a(Number(0), Number(0)), b(Number(big + 1), Number(big)), c(Number(big), Number(big - 1));
+        Vec<double, 2> da(0., 0.), db(double(big + 1), double(big)), dc(double(big), double(big - 1));
+        bool exact = orient2d(a, b, c) == -1 && orient2d(a, c, b) == 1 && orient2d(a, a, b) == 0 &&
+                     orient2d(da, db, dc) == 0;
+        NVec2 far(Number(4 * big), Number(4 * big)), farther(Number(4 * big), Number(-4 * big));
+        return exact && throwsOverflow([&] { return orient2d(a, far, farther); });
+    }
+
+    /**
+     * The determinant of the 3x3 Hilbert matrix, 1/2160, comes out exactly
+     */
+    bool checkDeterminant()
+    {
+        Mat<Number, 3, 3> hilbert;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                hilbert[i][j] = Number(1, static_cast<long long>(i + j + 1));
+            }
+        }
+        Mat<Number, 2, 2> singular{Number(1, 3), Number(2, 3), Number(1, 2), Number(1)};
+        return hilbert.determinant() == Number(1, 2160) && singular.determinant() == 0;
+    }
+}
+
+bool testNumber()
+{
+    bool ok = report("number normalization", checkNormalization());
+    ok = report("number overflow", checkOverflow()) && ok;
+    ok = report("orient2d", checkOrient()) && ok;
+    ok = report("exact determinant", checkDeterminant()) && ok;
+    return ok;
+}
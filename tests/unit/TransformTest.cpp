@@ -0,0 +1,174 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cmath>
+#include <random>
+#include "linear/Affine.h"
+#include "UnitTest.h"
+
+namespace
+{
+    /**
+     * Loose enough for float builds, with coordinates up to 10
+     */
+    constexpr Real tolerance = Real(1e-4);
+
+    bool near(const Vec3 &l, const Vec3 &r)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            if (std::abs(l[i] - r[i]) > tolerance * (1 + std::abs(r[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool near(const Mat4 &l, const Mat4 &r)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+            {
+                if (std::abs(l[i][j] - r[i][j]) > tolerance * (1 + std::abs(r[i][j])))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Same rotation: q and -q are
+     */
+    bool sameRotation(const Quaternion &l, const Quaternion &r)
+    {
+        return std::abs(std::abs(l.dot(r)) - 1) < tolerance;
+    }
+
+    /**
+     * Angle of the rotation taking l to r
+     */
+    Real angleBetween(const Quaternion &l, const Quaternion &r)
+    {
+        return 2 * std::acos(std::min(Real(1), std::abs(l.dot(r))));
+    }
+
+    Vec3 transform(const Mat4 &m, const Vec3 &p)
+    {
+        auto h = m * Vec4(p, Real(1));
+        return {h[0], h[1], h[2]};
+    }
+
+    struct Random
+    {
+        std::mt19937 engine{11};
+        std::uniform_real_distribution<Real> unit{-1, 1};
+
+        Vec3 vec3(Real scale)
+        {
+            return {unit(engine) * scale, unit(engine) * scale, unit(engine) * scale};
+        }
+
+        Quaternion rotation()
+        {
+            return Quaternion::fromAxisAngle(vec3(1) + Vec3{0, 0, Real(1e-3)}, unit(engine) * Real(M_PI));
+        }
+
+        Rigid3 rigid()
+        {
+            return {rotation(), vec3(10)};
+        }
+    };
+
+    /**
+     * A quaternion, its 3x3 matrix and the Mat4 built from it rotate vectors alike, and products of quaternions match
+     * products of their matrices
+     */
+    bool checkQuatMatrix()
+    {
+        Random random;
+        bool ok = true;
+        for (int i = 0; i < 200 && ok; ++i)
+        {
+            auto q = random.rotation(), r = random.rotation();
+            auto v = random.vec3(10);
+            auto m = Affine3(q, Vec3{0, 0, 0}).toMat4();
+            ok = near(transform(m, v), q.rotate(v)) && near(q.toMat3() * v, q.rotate(v));
+            ok = ok && near(Affine3(q * r, Vec3{0, 0, 0}).toMat4(), m * Affine3(r, Vec3{0, 0, 0}).toMat4());
+            ok = ok && sameRotation(Quaternion::fromMat3(q.toMat3()), q);
+        }
+        // A quarter turn about z takes x to y
+        auto quarter = Quaternion::fromAxisAngle({0, 0, 2}, Real(M_PI / 2));
+        return ok && near(quarter.rotate({1, 0, 0}), {0, 1, 0}) &&
+               near(transform(Affine3(quarter, Vec3{0, 0, 0}).toMat4(), {1, 0, 0}), {0, 1, 0});
+    }
+
+    /**
+     * Rigid transforms against their matrices: applying, composing and inverting, with the quaternion and with
+     * inverseRigid
+     */
+    bool checkRigid()
+    {
+        Random random;
+        Mat4 identity({1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1});
+        bool ok = true;
+        for (int i = 0; i < 200 && ok; ++i)
+        {
+            auto a = random.rigid(), b = random.rigid();
+            auto p = random.vec3(10);
+            auto affine = a.toAffine();
+            ok = near(transform(a.toMat4(), p), a.apply(p)) && near(affine.apply(p), a.apply(p));
+            ok = ok && near((a * b).toMat4(), a.toMat4() * b.toMat4());
+            ok = ok && near((affine.inverseRigid() * affine).toMat4(), identity) &&
+                 near((affine * affine.inverseRigid()).toMat4(), identity) &&
+                 near(affine.inverseRigid().toMat4(), affine.inverse().toMat4());
+            ok = ok && near((a.inverse() * a).toMat4(), identity) &&
+                 near(a.inverse().toMat4(), affine.inverseRigid().toMat4());
+        }
+        return ok;
+    }
+
+    /**
+     * Endpoints, constant angular speed, the shorter arc whichever sign the second quaternion has, and nearly equal
+     * rotations
+     */
+    bool checkSlerp()
+    {
+        Random random;
+        bool ok = true;
+        for (int i = 0; i < 200 && ok; ++i)
+        {
+            auto a = random.rotation(), b = random.rotation();
+            Quaternion negated(-b.getW(), -b.getX(), -b.getY(), -b.getZ());
+            auto far = b.dot(a) < 0 ? b : negated;
+            ok = sameRotation(Quaternion::slerp(a, b, 0), a) && sameRotation(Quaternion::slerp(a, b, 1), b) &&
+                 sameRotation(Quaternion::slerp(a, far, 1), b);
+            auto angle = angleBetween(a, b);
+            for (Real t: {Real(0.25), Real(0.5), Real(0.75)})
+            {
+                auto q = Quaternion::slerp(a, b, t);
+                ok = ok && std::abs(q.length() - 1) < tolerance &&
+                     std::abs(angleBetween(a, q) - t * angle) < 10 * tolerance &&
+                     std::abs(angleBetween(q, b) - (1 - t) * angle) < 10 * tolerance;
+                // On the far side of the sphere, slerp still takes the arc under half a turn
+                ok = ok && sameRotation(Quaternion::slerp(a, far, t), q);
+            }
+        }
+        auto a = Quaternion::fromAxisAngle({0, 1, 0}, Real(0.3)), b = Quaternion::fromAxisAngle({0, 1, 0}, Real(0.31));
+        auto mid = Quaternion::slerp(a, b, Real(0.5));
+        return ok && sameRotation(mid, Quaternion::fromAxisAngle({0, 1, 0}, Real(0.305))) &&
+               std::abs(mid.length() - 1) < tolerance;
+    }
+}
+
+bool testTransform()
+{
+    bool ok = report("quaternion against matrix", checkQuatMatrix());
+    ok = report("rigid against matrix", checkRigid()) && ok;
+    ok = report("slerp", checkSlerp()) && ok;
+    return ok;
+}
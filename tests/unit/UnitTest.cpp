@@ -0,0 +1,23 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "UnitTest.h"
+
+/**
+ * Checks of the code without an image to compare, module by module. Every check prints its outcome, and the exit
+ * status is 1 if any failed.
+ * Usage: unittest
+ */
+int main()
+{
+    int failures = 0;
+    failures += !testNumber();
+    failures += !testJobSystem();
+    failures += !testMeshLoader();
+    failures += !testAssetCache();
+    failures += !testBvh();
+    failures += !testBatch();
+    failures += !testTransform();
+    return failures == 0 ? 0 : 1;
+}
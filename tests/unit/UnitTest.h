@@ -0,0 +1,38 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef CG_UNITTEST_H
+#define CG_UNITTEST_H
+
+#include <iostream>
+
+/**
+ * Print the outcome of one check as goldentest does, "name: ok" or "name: FAILED"
+ * @return ok
+ */
+inline bool report(const char *name, bool ok)
+{
+    std::cout << name << ": " << (ok ? "ok" : "FAILED") << "\n";
+    return ok;
+}
+
+/**
+ * Checks of one module
+ * @return false if any failed
+ */
+bool testNumber();
+
+bool testJobSystem();
+
+bool testMeshLoader();
+
+bool testAssetCache();
+
+bool testBvh();
+
+bool testBatch();
+
+bool testTransform();
+
+#endif //CG_UNITTEST_H